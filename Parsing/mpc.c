@@ -1,6 +1,15 @@
 
 #include "mpc.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#define MPC_USE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 /*
 ** State Type
 */
@@ -50,6 +59,32 @@ static mpc_state_t mpc_state_new(void) {
 ** back we can simply start reading from the
 ** buffer instead of the input.
 **
+** The buffer only has to hold input the parser
+** can still read again. A failure is only ever
+** picked up by an alternative, a repetition or
+** an expectation, each of which reads on from
+** where it started, so input before the oldest
+** of these still on the stack is dropped when
+** the buffer fills. Marks older than that can
+** still be rewound to, but only on the way to
+** failing the whole parse, which reads nothing.
+** The buffer is emptied as soon as the last
+** mark is dropped, and otherwise grows
+** geometrically, so its size is bounded by how
+** far back the parser can rewind.
+**
+** When parsing the contents of a regular file by
+** name we try to map it into memory instead. It
+** is then scanned just like a String, only it is
+** not copied and is not null terminated, so reads
+** are checked against the length.
+**
+** Parsers wrapped with `mpc_memo` remember their
+** result at each position they are run, in a
+** small table owned by the input. This is only
+** allocated when first used, and being of a
+** fixed size, older results are simply evicted.
+**
 ** Of course using `mpc_predictive` will disable
 ** backtracking and make LL(1) grammars easy
 ** to parse for all input methods.
@@ -66,13 +101,58 @@ enum {
   MPC_INPUT_MARKS_MIN = 32
 };
 
+/*
+** Small blocks come from a pool kept by each input,
+** split into a few size classes. Each class is a run
+** of slots handed out in order and then reused from a
+** free list, so taking or returning one never scans.
+*/
+
+enum {
+  MPC_POOL_CLASSES = 4,
+  MPC_POOL_MIN = 16,
+  MPC_POOL_MAX = MPC_POOL_MIN << (MPC_POOL_CLASSES-1),
+  MPC_POOL_SLOTS = 512
+};
+
+enum {
+  MPC_INPUT_BUFFER_MIN = 64,
+  MPC_INPUT_BUFFER_KEEP = 4096
+};
+
+enum {
+  MPC_INPUT_MEMO_NUM = 4096
+};
+
 enum {
-  MPC_INPUT_MEM_NUM = 512
+  MPC_INPUT_FRAMES_MIN = 64,
+  MPC_INPUT_FRAMES_KEEP = 4096
 };
 
 typedef struct {
-  char mem[64];
-} mpc_mem_t;
+  mpc_parser_t *parser;
+  long pos;
+  int suppress;
+  int success;
+  mpc_state_t state;
+  char last;
+  mpc_result_t result;
+} mpc_memo_t;
+
+enum {
+  MPC_PARSE_STACK_MIN = 4
+};
+
+typedef struct {
+  mpc_parser_t *parser;
+  int j;
+  int k;
+  int results_slots;
+  mpc_result_t *results;
+  mpc_result_t results_stk[MPC_PARSE_STACK_MIN];
+  mpc_memo_t *memo;
+  long pos;
+} mpc_frame_t;
 
 typedef struct {
 
@@ -81,7 +161,12 @@ typedef struct {
   mpc_state_t state;
   
   char *string;
+  long length;
+  int mapped;
   char *buffer;
+  long buffer_pos;
+  long buffer_len;
+  long buffer_cap;
   FILE *file;
   
   int suppress;
@@ -93,12 +178,28 @@ typedef struct {
   char *lasts;
   char last;
   
-  size_t mem_index;
-  char mem_full[MPC_INPUT_MEM_NUM];
-  mpc_mem_t mem[MPC_INPUT_MEM_NUM];
+  char *pool;
+  char *pool_class[MPC_POOL_CLASSES+1];
+  long pool_slots;
+  long pool_used[MPC_POOL_CLASSES];
+  void *pool_free[MPC_POOL_CLASSES];
+  long pool_hits;
+  long pool_misses;
+  
+  mpc_memo_t *memo;
+  mpc_ast_arena_t *arena;
+  
+  int frames_num;
+  int frames_slots;
+  mpc_frame_t *frames;
+  
+  int exact;
   
 } mpc_input_t;
 
+/* Taken by each input as it is made, see mpc_pool_capacity */
+static long mpc_pool_slots = MPC_POOL_SLOTS;
+
 static mpc_input_t *mpc_input_new_string(const char *filename, const char *string) {
 
   mpc_input_t *i = malloc(sizeof(mpc_input_t));
@@ -109,9 +210,14 @@ static mpc_input_t *mpc_input_new_string(const char *filename, const char *strin
   
   i->state = mpc_state_new();
   
-  i->string = malloc(strlen(string) + 1);
-  strcpy(i->string, string);
+  i->length = strlen(string);
+  i->string = malloc(i->length + 1);
+  memcpy(i->string, string, i->length + 1);
+  i->mapped = 0;
   i->buffer = NULL;
+  i->buffer_pos = 0;
+  i->buffer_len = 0;
+  i->buffer_cap = 0;
   i->file = NULL;
   
   i->suppress = 0;
@@ -122,8 +228,17 @@ static mpc_input_t *mpc_input_new_string(const char *filename, const char *strin
   i->lasts = malloc(sizeof(char) * i->marks_slots);
   i->last = '\0';
   
-  i->mem_index = 0;
-  memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
+  i->pool = NULL;
+  i->pool_slots = mpc_pool_slots;
+  i->pool_hits = 0;
+  i->pool_misses = 0;
+  
+  i->memo = NULL;
+  i->arena = NULL;
+  i->frames_num = 0;
+  i->frames_slots = 0;
+  i->frames = NULL;
+  i->exact = 0;
   
   return i;
 }
@@ -141,7 +256,12 @@ static mpc_input_t *mpc_input_new_nstring(const char *filename, const char *stri
   i->string = malloc(length + 1);
   strncpy(i->string, string, length);
   i->string[length] = '\0';
+  i->length = strlen(i->string);
+  i->mapped = 0;
   i->buffer = NULL;
+  i->buffer_pos = 0;
+  i->buffer_len = 0;
+  i->buffer_cap = 0;
   i->file = NULL;
   
   i->suppress = 0;
@@ -152,8 +272,17 @@ static mpc_input_t *mpc_input_new_nstring(const char *filename, const char *stri
   i->lasts = malloc(sizeof(char) * i->marks_slots);
   i->last = '\0';
   
-  i->mem_index = 0;
-  memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
+  i->pool = NULL;
+  i->pool_slots = mpc_pool_slots;
+  i->pool_hits = 0;
+  i->pool_misses = 0;
+  
+  i->memo = NULL;
+  i->arena = NULL;
+  i->frames_num = 0;
+  i->frames_slots = 0;
+  i->frames = NULL;
+  i->exact = 0;
   
   return i;
 
@@ -170,7 +299,12 @@ static mpc_input_t *mpc_input_new_pipe(const char *filename, FILE *pipe) {
   i->state = mpc_state_new();
   
   i->string = NULL;
+  i->length = 0;
+  i->mapped = 0;
   i->buffer = NULL;
+  i->buffer_pos = 0;
+  i->buffer_len = 0;
+  i->buffer_cap = 0;
   i->file = pipe;
   
   i->suppress = 0;
@@ -181,8 +315,17 @@ static mpc_input_t *mpc_input_new_pipe(const char *filename, FILE *pipe) {
   i->lasts = malloc(sizeof(char) * i->marks_slots);
   i->last = '\0';
   
-  i->mem_index = 0;
-  memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
+  i->pool = NULL;
+  i->pool_slots = mpc_pool_slots;
+  i->pool_hits = 0;
+  i->pool_misses = 0;
+  
+  i->memo = NULL;
+  i->arena = NULL;
+  i->frames_num = 0;
+  i->frames_slots = 0;
+  i->frames = NULL;
+  i->exact = 0;
   
   return i;
   
@@ -198,7 +341,12 @@ static mpc_input_t *mpc_input_new_file(const char *filename, FILE *file) {
   i->state = mpc_state_new();
   
   i->string = NULL;
+  i->length = 0;
+  i->mapped = 0;
   i->buffer = NULL;
+  i->buffer_pos = 0;
+  i->buffer_len = 0;
+  i->buffer_cap = 0;
   i->file = file;
   
   i->suppress = 0;
@@ -209,47 +357,152 @@ static mpc_input_t *mpc_input_new_file(const char *filename, FILE *file) {
   i->lasts = malloc(sizeof(char) * i->marks_slots);
   i->last = '\0';
   
-  i->mem_index = 0;
-  memset(i->mem_full, 0, sizeof(char) * MPC_INPUT_MEM_NUM);
+  i->pool = NULL;
+  i->pool_slots = mpc_pool_slots;
+  i->pool_hits = 0;
+  i->pool_misses = 0;
+  
+  i->memo = NULL;
+  i->arena = NULL;
+  i->frames_num = 0;
+  i->frames_slots = 0;
+  i->frames = NULL;
+  i->exact = 0;
+  
+  return i;
+}
+
+#ifdef MPC_USE_MMAP
+
+static mpc_input_t *mpc_input_new_mmap(const char *filename) {
+  
+  mpc_input_t *i;
+  struct stat st;
+  void *data;
+  int fd = open(filename, O_RDONLY);
+  
+  if (fd < 0) { return NULL; }
+  
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0) {
+    close(fd);
+    return NULL;
+  }
+  
+  data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  
+  if (data == MAP_FAILED) { return NULL; }
+  
+  i = mpc_input_new_string(filename, "");
+  free(i->string);
+  i->string = data;
+  i->length = st.st_size;
+  i->mapped = 1;
   
   return i;
 }
 
+#else
+
+static mpc_input_t *mpc_input_new_mmap(const char *filename) {
+  (void)filename;
+  return NULL;
+}
+
+#endif
+
+static void mpc_input_memo_clear(mpc_input_t *i);
+
+static long mpc_pool_hits = 0;
+static long mpc_pool_misses = 0;
+
+void mpc_pool_capacity(long slots) {
+  mpc_pool_slots = slots > 0 ? slots : 0;
+}
+
+void mpc_pool_stats(long *hits, long *misses) {
+  if (hits) { *hits = mpc_pool_hits; }
+  if (misses) { *misses = mpc_pool_misses; }
+}
+
 static void mpc_input_delete(mpc_input_t *i) {
   
+  mpc_input_memo_clear(i);
   free(i->filename);
   
-  if (i->type == MPC_INPUT_STRING) { free(i->string); }
+  mpc_pool_hits += i->pool_hits;
+  mpc_pool_misses += i->pool_misses;
+  free(i->pool);
+  
+#ifdef MPC_USE_MMAP
+  if (i->mapped) { munmap(i->string, i->length); }
+#endif
+  if (i->type == MPC_INPUT_STRING && !i->mapped) { free(i->string); }
   if (i->type == MPC_INPUT_PIPE) { free(i->buffer); }
   
   free(i->marks);
   free(i->lasts);
+  free(i->frames);
   free(i);
 }
 
 static int mpc_mem_ptr(mpc_input_t *i, void *p) {
-  return
-    (char*)p >= (char*)(i->mem) &&
-    (char*)p <  (char*)(i->mem) + (MPC_INPUT_MEM_NUM * sizeof(mpc_mem_t));
+  return i->pool && (char*)p >= i->pool && (char*)p < i->pool_class[MPC_POOL_CLASSES];
+}
+
+static int mpc_pool_class(mpc_input_t *i, void *p) {
+  int c = 0;
+  while ((char*)p >= i->pool_class[c+1]) { c++; }
+  return c;
+}
+
+/* Only valid once nothing handed out by the pool is still in use */
+static void mpc_pool_reset(mpc_input_t *i) {
+  int c;
+  for (c = 0; c < MPC_POOL_CLASSES; c++) {
+    i->pool_used[c] = 0;
+    i->pool_free[c] = NULL;
+  }
+}
+
+/* Class c holds blocks of MPC_POOL_MIN << c bytes, after all the smaller classes */
+static void mpc_pool_init(mpc_input_t *i) {
+  int c;
+  i->pool = malloc(i->pool_slots * MPC_POOL_MIN * ((1 << MPC_POOL_CLASSES) - 1));
+  for (c = 0; c <= MPC_POOL_CLASSES; c++) {
+    i->pool_class[c] = i->pool + i->pool_slots * MPC_POOL_MIN * ((1 << c) - 1);
+  }
+  mpc_pool_reset(i);
 }
 
 static void *mpc_malloc(mpc_input_t *i, size_t n) {
-  size_t j;
+  
+  int c = 0;
   char *p;
   
-  if (n > sizeof(mpc_mem_t)) { return malloc(n); }
+  if (n > MPC_POOL_MAX || i->pool_slots == 0) {
+    i->pool_misses++;
+    return malloc(n);
+  }
+  
+  if (i->pool == NULL) { mpc_pool_init(i); }
   
-  j = i->mem_index;
-  do {
-    if (!i->mem_full[i->mem_index]) {
-      p = (void*)(i->mem + i->mem_index);
-      i->mem_full[i->mem_index] = 1;
-      i->mem_index = (i->mem_index+1) % MPC_INPUT_MEM_NUM;
-      return p;
-    }
-    i->mem_index = (i->mem_index+1) % MPC_INPUT_MEM_NUM;
-  } while (j != i->mem_index);
+  while ((size_t)(MPC_POOL_MIN << c) < n) { c++; }
+  
+  if (i->pool_free[c]) {
+    p = i->pool_free[c];
+    i->pool_free[c] = *(void**)p;
+    i->pool_hits++;
+    return p;
+  }
+  
+  if (i->pool_used[c] < i->pool_slots) {
+    p = i->pool_class[c] + (i->pool_used[c]++ * (MPC_POOL_MIN << c));
+    i->pool_hits++;
+    return p;
+  }
   
+  i->pool_misses++;
   return malloc(n);
 }
 
@@ -260,21 +513,24 @@ static void *mpc_calloc(mpc_input_t *i, size_t n, size_t m) {
 }
 
 static void mpc_free(mpc_input_t *i, void *p) {
-  size_t j;
+  int c;
   if (!mpc_mem_ptr(i, p)) { free(p); return; }
-  j = ((size_t)(((char*)p) - ((char*)i->mem))) / sizeof(mpc_mem_t);
-  i->mem_full[j] = 0;
+  c = mpc_pool_class(i, p);
+  *(void**)p = i->pool_free[c];
+  i->pool_free[c] = p;
 }
 
 static void *mpc_realloc(mpc_input_t *i, void *p, size_t n) {
   
   char *q = NULL;
+  size_t m;
   
   if (!mpc_mem_ptr(i, p)) { return realloc(p, n); }
   
-  if (n > sizeof(mpc_mem_t)) {
-    q = malloc(n);
-    memcpy(q, p, sizeof(mpc_mem_t));
+  m = MPC_POOL_MIN << mpc_pool_class(i, p);
+  if (n > m) {
+    q = mpc_malloc(i, n);
+    memcpy(q, p, m);
     mpc_free(i, p);
     return q;
   }
@@ -284,13 +540,375 @@ static void *mpc_realloc(mpc_input_t *i, void *p, size_t n) {
 
 static void *mpc_export(mpc_input_t *i, void *p) {
   char *q = NULL;
+  size_t m;
   if (!mpc_mem_ptr(i, p)) { return p; }
-  q = malloc(sizeof(mpc_mem_t));
-  memcpy(q, p, sizeof(mpc_mem_t));
+  m = MPC_POOL_MIN << mpc_pool_class(i, p);
+  q = malloc(m);
+  memcpy(q, p, m);
   mpc_free(i, p);
   return q; 
 }
 
+/*
+** Tag Interning
+**
+** Names are kept for the life of the process. Only
+** the first few dozen ids fit in the set kept on each
+** node, later ones are looked for in the tag string.
+*/
+
+enum {
+  MPC_TAG_BITS = sizeof(unsigned long) * 8,
+  MPC_TAG_SLOTS_MIN = 64
+};
+
+typedef struct {
+  char *name;
+  size_t len;
+  int id;
+} mpc_tag_t;
+
+static mpc_tag_t **mpc_tags = NULL;
+static int mpc_tags_num = 0;
+static int *mpc_tags_hash = NULL;
+static int mpc_tags_slots = 0;
+
+static int *mpc_tag_slot(const char *s, size_t n) {
+  
+  size_t j;
+  unsigned long h = 5381;
+  int k;
+  
+  for (j = 0; j < n; j++) { h = h * 33 + (unsigned char)s[j]; }
+  k = (int)(h & (unsigned long)(mpc_tags_slots - 1));
+  
+  while (mpc_tags_hash[k]) {
+    mpc_tag_t *t = mpc_tags[mpc_tags_hash[k]-1];
+    if (t->len == n && memcmp(t->name, s, n) == 0) { break; }
+    k = (k + 1) & (mpc_tags_slots - 1);
+  }
+  
+  return &mpc_tags_hash[k];
+}
+
+static mpc_tag_t *mpc_tag_intern(const char *s, size_t n) {
+  
+  int j;
+  int *slot;
+  mpc_tag_t *t;
+  
+  if (mpc_tags_slots == 0) {
+    mpc_tags_slots = MPC_TAG_SLOTS_MIN;
+    mpc_tags_hash = calloc(mpc_tags_slots, sizeof(int));
+  }
+  
+  slot = mpc_tag_slot(s, n);
+  if (*slot) { return mpc_tags[*slot-1]; }
+  
+  t = malloc(sizeof(mpc_tag_t));
+  t->name = malloc(n + 1);
+  memcpy(t->name, s, n);
+  t->name[n] = '\0';
+  t->len = n;
+  t->id = mpc_tags_num;
+  
+  mpc_tags_num++;
+  mpc_tags = realloc(mpc_tags, sizeof(mpc_tag_t*) * mpc_tags_num);
+  mpc_tags[t->id] = t;
+  *slot = mpc_tags_num;
+  
+  if (mpc_tags_num * 2 > mpc_tags_slots) {
+    mpc_tags_slots *= 2;
+    free(mpc_tags_hash);
+    mpc_tags_hash = calloc(mpc_tags_slots, sizeof(int));
+    for (j = 0; j < mpc_tags_num; j++) {
+      *mpc_tag_slot(mpc_tags[j]->name, mpc_tags[j]->len) = j + 1;
+    }
+  }
+  
+  return t;
+}
+
+static unsigned long mpc_tag_bit(int id) {
+  return id < MPC_TAG_BITS ? 1UL << id : 0;
+}
+
+static unsigned long mpc_tagset(const char *t) {
+  
+  unsigned long set = 0;
+  const char *e;
+  
+  while (*t) {
+    e = strchr(t, '|');
+    if (e == NULL) { e = t + strlen(t); }
+    if (e > t && !(e - t == 1 && *t == '>')) {
+      set |= mpc_tag_bit(mpc_tag_intern(t, e - t)->id);
+    }
+    t = *e ? e + 1 : e;
+  }
+  
+  return set;
+}
+
+int mpc_tag_id(const char *name) {
+  return mpc_tag_intern(name, strlen(name))->id;
+}
+
+int mpc_ast_has_tag(mpc_ast_t *a, int id) {
+  
+  const char *t, *e;
+  size_t n;
+  
+  if (id < 0 || id >= mpc_tags_num) { return 0; }
+  if (id < MPC_TAG_BITS) { return (a->tagset >> id) & 1; }
+  
+  n = mpc_tags[id]->len;
+  for (t = a->tag; *t; t = *e ? e + 1 : e) {
+    e = strchr(t, '|');
+    if (e == NULL) { e = t + strlen(t); }
+    if ((size_t)(e - t) == n && memcmp(t, mpc_tags[id]->name, n) == 0) { return 1; }
+  }
+  
+  return 0;
+}
+
+/* Used by mpca_tag and mpca_add_tag, which intern the tag up front */
+
+static mpc_val_t *mpcf_tag_ast(mpc_val_t *x, void *d) {
+  mpc_ast_t *a = x;
+  mpc_tag_t *t = d;
+  if (a == NULL) { return a; }
+  a->tag = realloc(a->tag, t->len + 1);
+  memcpy(a->tag, t->name, t->len + 1);
+  a->tagset = mpc_tag_bit(t->id);
+  return a;
+}
+
+static mpc_val_t *mpcf_add_tag_ast(mpc_val_t *x, void *d) {
+  mpc_ast_t *a = x;
+  mpc_tag_t *t = d;
+  size_t n;
+  if (a == NULL) { return a; }
+  n = strlen(a->tag);
+  a->tag = realloc(a->tag, t->len + 1 + n + 1);
+  memmove(a->tag + t->len + 1, a->tag, n + 1);
+  memcpy(a->tag, t->name, t->len);
+  a->tag[t->len] = '|';
+  a->tagset |= mpc_tag_bit(t->id);
+  return a;
+}
+
+/*
+** AST Arena
+**
+** Blocks double in size as the arena grows, so there
+** are only ever a few of them to search when asking
+** if a pointer came from the arena.
+**
+** An arena made for views also takes over the text
+** of each String input parsed into it, so that token
+** contents can point straight into the text instead
+** of being copied out of it.
+*/
+
+enum {
+  MPC_AST_ARENA_BLOCK = 4096,
+  MPC_AST_ARENA_ALIGN = 8
+};
+
+typedef struct mpc_ast_block_t {
+  struct mpc_ast_block_t *next;
+  size_t size;
+  size_t used;
+} mpc_ast_block_t;
+
+typedef struct mpc_ast_text_t {
+  struct mpc_ast_text_t *next;
+  char *string;
+  long length;
+  int mapped;
+} mpc_ast_text_t;
+
+struct mpc_ast_arena_t {
+  mpc_ast_block_t *blocks;
+  mpc_ast_text_t *texts;
+  int views;
+};
+
+mpc_ast_arena_t *mpc_ast_arena_new(void) {
+  mpc_ast_arena_t *a = malloc(sizeof(mpc_ast_arena_t));
+  a->blocks = NULL;
+  a->texts = NULL;
+  a->views = 0;
+  return a;
+}
+
+mpc_ast_arena_t *mpc_ast_arena_new_views(void) {
+  mpc_ast_arena_t *a = mpc_ast_arena_new();
+  a->views = 1;
+  return a;
+}
+
+static void mpc_ast_arena_texts_free(mpc_ast_arena_t *a) {
+  mpc_ast_text_t *t;
+  while (a->texts) {
+    t = a->texts;
+    a->texts = t->next;
+#ifdef MPC_USE_MMAP
+    if (t->mapped) { munmap(t->string, t->length); }
+#endif
+    if (!t->mapped) { free(t->string); }
+    free(t);
+  }
+}
+
+void mpc_ast_arena_clear(mpc_ast_arena_t *a) {
+  
+  mpc_ast_block_t *b;
+  
+  mpc_ast_arena_texts_free(a);
+  
+  /* Keep the largest block for the next tree */
+  if (a->blocks == NULL) { return; }
+  while (a->blocks->next) {
+    b = a->blocks->next;
+    a->blocks->next = b->next;
+    free(b);
+  }
+  a->blocks->used = 0;
+}
+
+void mpc_ast_arena_delete(mpc_ast_arena_t *a) {
+  mpc_ast_block_t *b;
+  mpc_ast_arena_texts_free(a);
+  while (a->blocks) {
+    b = a->blocks;
+    a->blocks = b->next;
+    free(b);
+  }
+  free(a);
+}
+
+static int mpc_input_views(mpc_input_t *i) {
+  return i->arena && i->arena->views && i->type == MPC_INPUT_STRING;
+}
+
+/* Called before the input is deleted, so the views into it stay valid */
+static void mpc_ast_arena_keep(mpc_input_t *i) {
+  
+  mpc_ast_text_t *t;
+  
+  if (!mpc_input_views(i)) { return; }
+  
+  t = malloc(sizeof(mpc_ast_text_t));
+  t->string = i->string;
+  t->length = i->length;
+  t->mapped = i->mapped;
+  t->next = i->arena->texts;
+  i->arena->texts = t;
+  
+  i->string = NULL;
+  i->mapped = 0;
+}
+
+static void *mpc_ast_arena_alloc(mpc_ast_arena_t *a, size_t n) {
+  
+  mpc_ast_block_t *b = a->blocks;
+  size_t size;
+  char *p;
+  
+  n = (n + MPC_AST_ARENA_ALIGN - 1) & ~(size_t)(MPC_AST_ARENA_ALIGN - 1);
+  
+  if (b == NULL || b->used + n > b->size) {
+    size = b ? b->size * 2 : MPC_AST_ARENA_BLOCK;
+    while (size < n) { size *= 2; }
+    b = malloc(sizeof(mpc_ast_block_t) + size);
+    b->next = a->blocks;
+    b->size = size;
+    b->used = 0;
+    a->blocks = b;
+  }
+  
+  p = (char*)(b + 1) + b->used;
+  b->used += n;
+  return p;
+}
+
+static int mpc_ast_arena_owns(mpc_ast_arena_t *a, void *p) {
+  mpc_ast_block_t *b;
+  for (b = a->blocks; b; b = b->next) {
+    if ((char*)p >= (char*)(b + 1) && (char*)p < (char*)(b + 1) + b->used) { return 1; }
+  }
+  return 0;
+}
+
+static char *mpc_ast_arena_strn(mpc_ast_arena_t *a, const char *x, size_t n) {
+  char *s = mpc_ast_arena_alloc(a, n + 1);
+  memcpy(s, x, n);
+  s[n] = '\0';
+  return s;
+}
+
+static char *mpc_ast_arena_str(mpc_ast_arena_t *a, const char *x) {
+  return mpc_ast_arena_strn(a, x, strlen(x));
+}
+
+static mpc_ast_t *mpc_ast_arena_node(mpc_ast_arena_t *a, const char *tag, const char *contents, int children) {
+  mpc_ast_t *r = mpc_ast_arena_alloc(a, sizeof(mpc_ast_t));
+  r->tag = mpc_ast_arena_str(a, tag);
+  r->contents = contents ? mpc_ast_arena_str(a, contents) : NULL;
+  r->contents_len = contents ? (long)strlen(contents) : 0;
+  r->state = mpc_state_new();
+  r->children_num = 0;
+  r->children = children ? mpc_ast_arena_alloc(a, sizeof(mpc_ast_t*) * children) : NULL;
+  r->tagset = 0;
+  return r;
+}
+
+/*
+** Nothing in an arena tree is changed in place, so
+** copies within the arena share their strings with
+** the original. Copies from the heap cannot.
+*/
+
+static mpc_ast_t *mpc_ast_arena_copy(mpc_ast_arena_t *a, mpc_ast_t *x, int share) {
+  
+  int j;
+  mpc_ast_t *r;
+  
+  if (x == NULL) { return NULL; }
+  
+  r = mpc_ast_arena_alloc(a, sizeof(mpc_ast_t));
+  r->tag = share ? x->tag : mpc_ast_arena_str(a, x->tag);
+  r->contents = share ? x->contents : mpc_ast_arena_strn(a, x->contents, x->contents_len);
+  r->contents_len = x->contents_len;
+  r->state = x->state;
+  r->tagset = x->tagset;
+  r->children_num = 0;
+  r->children = x->children_num ? mpc_ast_arena_alloc(a, sizeof(mpc_ast_t*) * x->children_num) : NULL;
+  for (j = 0; j < x->children_num; j++) {
+    r->children[r->children_num++] = mpc_ast_arena_copy(a, x->children[j], share);
+  }
+  return r;
+}
+
+/* Trees built by user functions are moved into the arena as they join it */
+static mpc_ast_t *mpc_ast_arena_import(mpc_ast_arena_t *a, mpc_ast_t *x) {
+  mpc_ast_t *r;
+  if (x == NULL || mpc_ast_arena_owns(a, x)) { return x; }
+  r = mpc_ast_arena_copy(a, x, 0);
+  mpc_ast_delete(x);
+  return r;
+}
+
+/* User functions only ever see trees from the heap */
+static void *mpc_export_user(mpc_input_t *i, void *p) {
+  if (i->arena && mpc_ast_arena_owns(i->arena, p)) {
+    return mpc_ast_copy(p);
+  }
+  return mpc_export(i, p);
+}
+
 static void mpc_input_backtrack_disable(mpc_input_t *i) { i->backtrack--; }
 static void mpc_input_backtrack_enable(mpc_input_t *i) { i->backtrack++; }
 
@@ -313,7 +931,12 @@ static void mpc_input_mark(mpc_input_t *i) {
   i->lasts[i->marks_num-1] = i->last;
   
   if (i->type == MPC_INPUT_PIPE && i->marks_num == 1) {
-    i->buffer = calloc(1, 1);
+    if (!i->buffer) {
+      i->buffer_cap = MPC_INPUT_BUFFER_MIN;
+      i->buffer = malloc(i->buffer_cap);
+    }
+    i->buffer_pos = i->state.pos;
+    i->buffer_len = 0;
   }
   
 }
@@ -333,9 +956,14 @@ static void mpc_input_unmark(mpc_input_t *i) {
     i->lasts = realloc(i->lasts, sizeof(char) * i->marks_slots);      
   }
   
+  /* Nothing can rewind into the buffer now, only keep small ones around */
   if (i->type == MPC_INPUT_PIPE && i->marks_num == 0) {
-    free(i->buffer);
-    i->buffer = NULL;
+    i->buffer_len = 0;
+    if (i->buffer_cap > MPC_INPUT_BUFFER_KEEP) {
+      free(i->buffer);
+      i->buffer = NULL;
+      i->buffer_cap = 0;
+    }
   }
   
 }
@@ -354,16 +982,39 @@ static void mpc_input_rewind(mpc_input_t *i) {
   mpc_input_unmark(i);
 }
 
+static int mpc_input_buffering(mpc_input_t *i) {
+  return i->marks_num > 0;
+}
+
 static int mpc_input_buffer_in_range(mpc_input_t *i) {
-  return i->state.pos < (long)(strlen(i->buffer) + i->marks[0].pos);
+  return i->state.pos < i->buffer_pos + i->buffer_len;
 }
 
 static char mpc_input_buffer_get(mpc_input_t *i) {
-  return i->buffer[i->state.pos - i->marks[0].pos];
+  return i->buffer[i->state.pos - i->buffer_pos];
+}
+
+static long mpc_input_floor(mpc_input_t *i);
+
+/* Drops what can no longer be read, and grows if that frees too little */
+static void mpc_input_buffer_make_room(mpc_input_t *i) {
+  
+  long drop = mpc_input_floor(i) - i->buffer_pos;
+  
+  if (drop > 0) {
+    memmove(i->buffer, i->buffer + drop, i->buffer_len - drop);
+    i->buffer_pos += drop;
+    i->buffer_len -= drop;
+  }
+  
+  if (i->buffer_len > i->buffer_cap / 2) {
+    i->buffer_cap *= 2;
+    i->buffer = realloc(i->buffer, i->buffer_cap);
+  }
 }
 
 static int mpc_input_terminated(mpc_input_t *i) {
-  if (i->type == MPC_INPUT_STRING && i->state.pos == (long)strlen(i->string)) { return 1; }
+  if (i->type == MPC_INPUT_STRING && i->state.pos == i->length) { return 1; }
   if (i->type == MPC_INPUT_FILE && feof(i->file)) { return 1; }
   if (i->type == MPC_INPUT_PIPE && feof(i->file)) { return 1; }
   return 0;
@@ -375,13 +1026,14 @@ static char mpc_input_getc(mpc_input_t *i) {
   
   switch (i->type) {
     
-    case MPC_INPUT_STRING: return i->string[i->state.pos];
+    case MPC_INPUT_STRING:
+      return i->state.pos < i->length ? i->string[i->state.pos] : '\0';
     case MPC_INPUT_FILE: c = fgetc(i->file); return c;
     case MPC_INPUT_PIPE:
     
-      if (!i->buffer) { c = getc(i->file); return c; }
+      if (!mpc_input_buffering(i)) { c = getc(i->file); return c; }
       
-      if (i->buffer && mpc_input_buffer_in_range(i)) {
+      if (mpc_input_buffer_in_range(i)) {
         c = mpc_input_buffer_get(i);
         return c;
       } else {
@@ -398,7 +1050,8 @@ static char mpc_input_peekc(mpc_input_t *i) {
   char c = '\0';
   
   switch (i->type) {
-    case MPC_INPUT_STRING: return i->string[i->state.pos];
+    case MPC_INPUT_STRING:
+      return i->state.pos < i->length ? i->string[i->state.pos] : '\0';
     case MPC_INPUT_FILE: 
       
       c = fgetc(i->file);
@@ -409,14 +1062,14 @@ static char mpc_input_peekc(mpc_input_t *i) {
     
     case MPC_INPUT_PIPE:
       
-      if (!i->buffer) {
+      if (!mpc_input_buffering(i)) {
         c = getc(i->file);
         if (feof(i->file)) { return '\0'; }
         ungetc(c, i->file);
         return c;
       }
       
-      if (i->buffer && mpc_input_buffer_in_range(i)) {
+      if (mpc_input_buffer_in_range(i)) {
         return mpc_input_buffer_get(i);
       } else {
         c = getc(i->file);
@@ -437,9 +1090,9 @@ static int mpc_input_failure(mpc_input_t *i, char c) {
     case MPC_INPUT_FILE: fseek(i->file, -1, SEEK_CUR); { break; }
     case MPC_INPUT_PIPE: {
       
-      if (!i->buffer) { ungetc(c, i->file); break; }
+      if (!mpc_input_buffering(i)) { ungetc(c, i->file); break; }
       
-      if (i->buffer && mpc_input_buffer_in_range(i)) {
+      if (mpc_input_buffer_in_range(i)) {
         break;
       } else {
         ungetc(c, i->file); 
@@ -453,10 +1106,9 @@ static int mpc_input_failure(mpc_input_t *i, char c) {
 static int mpc_input_success(mpc_input_t *i, char c, char **o) {
   
   if (i->type == MPC_INPUT_PIPE
-  &&  i->buffer && !mpc_input_buffer_in_range(i)) {
-    i->buffer = realloc(i->buffer, strlen(i->buffer) + 2);
-    i->buffer[strlen(i->buffer) + 1] = '\0';
-    i->buffer[strlen(i->buffer) + 0] = c;
+  &&  mpc_input_buffering(i) && !mpc_input_buffer_in_range(i)) {
+    if (i->buffer_len == i->buffer_cap) { mpc_input_buffer_make_room(i); }
+    i->buffer[i->buffer_len++] = c;
   }
   
   i->last = c;
@@ -527,8 +1179,10 @@ static int mpc_input_string(mpc_input_t *i, const char *c, char **o) {
   }
   mpc_input_unmark(i);
   
-  *o = mpc_malloc(i, strlen(c) + 1);
-  strcpy(*o, c);
+  if (o) {
+    *o = mpc_malloc(i, strlen(c) + 1);
+    strcpy(*o, c);
+  }
   return 1;
 }
 
@@ -704,6 +1358,29 @@ static mpc_err_t *mpc_err_export(mpc_input_t *i, mpc_err_t *x) {
   return mpc_export(i, x);
 }
 
+static mpc_err_t *mpc_err_copy(mpc_input_t *i, mpc_err_t *x) {
+  int j;
+  mpc_err_t *y;
+  if (x == NULL) { return NULL; }
+  y = mpc_malloc(i, sizeof(mpc_err_t));
+  y->filename = mpc_malloc(i, strlen(x->filename) + 1);
+  strcpy(y->filename, x->filename);
+  y->state = x->state;
+  y->expected_num = x->expected_num;
+  y->expected = x->expected_num ? mpc_malloc(i, sizeof(char*) * x->expected_num) : NULL;
+  for (j = 0; j < x->expected_num; j++) {
+    y->expected[j] = mpc_malloc(i, strlen(x->expected[j]) + 1);
+    strcpy(y->expected[j], x->expected[j]);
+  }
+  y->failure = NULL;
+  if (x->failure) {
+    y->failure = mpc_malloc(i, strlen(x->failure) + 1);
+    strcpy(y->failure, x->failure);
+  }
+  y->recieved = x->recieved;
+  return y;
+}
+
 static int mpc_err_contains_expected(mpc_input_t *i, mpc_err_t *x, char *expected) {
   int j;
   (void)i;
@@ -883,7 +1560,11 @@ enum {
   MPC_TYPE_COUNT     = 22,
   
   MPC_TYPE_OR        = 23,
-  MPC_TYPE_AND       = 24
+  MPC_TYPE_AND       = 24,
+  
+  MPC_TYPE_MEMO      = 25,
+  MPC_TYPE_DFA       = 26,
+  MPC_TYPE_JUMP      = 27
 };
 
 typedef struct { char *m; } mpc_pdata_fail_t;
@@ -897,6 +1578,9 @@ typedef struct { char *x; } mpc_pdata_string_t;
 typedef struct { mpc_parser_t *x; mpc_apply_t f; } mpc_pdata_apply_t;
 typedef struct { mpc_parser_t *x; mpc_apply_to_t f; void *d; } mpc_pdata_apply_to_t;
 typedef struct { mpc_parser_t *x; } mpc_pdata_predict_t;
+typedef struct { mpc_parser_t *x; mpc_apply_t copy; mpc_dtor_t dx; long lookups; long hits; } mpc_pdata_memo_t;
+typedef struct { mpc_parser_t *x; int states; int classes_num; unsigned char *classes; char *accept; short *trans; } mpc_pdata_dfa_t;
+typedef struct { mpc_parser_t *x; int *start; int conflicts; } mpc_pdata_jump_t;
 typedef struct { mpc_parser_t *x; mpc_dtor_t dx; mpc_ctor_t lf; } mpc_pdata_not_t;
 typedef struct { int n; mpc_fold_t f; mpc_parser_t *x; mpc_dtor_t dx; } mpc_pdata_repeat_t;
 typedef struct { int n; mpc_parser_t **xs; } mpc_pdata_or_t;
@@ -914,6 +1598,9 @@ typedef union {
   mpc_pdata_apply_t apply;
   mpc_pdata_apply_to_t apply_to;
   mpc_pdata_predict_t predict;
+  mpc_pdata_memo_t memo;
+  mpc_pdata_dfa_t dfa;
+  mpc_pdata_jump_t jump;
   mpc_pdata_not_t not;
   mpc_pdata_repeat_t repeat;
   mpc_pdata_and_t and;
@@ -956,18 +1643,72 @@ static mpc_val_t *mpcf_input_state_ast(mpc_input_t *i, int n, mpc_val_t **xs) {
   return a;
 }
 
-static mpc_val_t *mpc_parse_fold(mpc_input_t *i, mpc_fold_t f, int n, mpc_val_t **xs) {
-  int j;
-  if (f == mpcf_null)      { return mpcf_null(n, xs); }
-  if (f == mpcf_fst)       { return mpcf_fst(n, xs); }
-  if (f == mpcf_snd)       { return mpcf_snd(n, xs); }
-  if (f == mpcf_trd)       { return mpcf_trd(n, xs); }
-  if (f == mpcf_fst_free)  { return mpcf_input_fst_free(i, n, xs); }
-  if (f == mpcf_snd_free)  { return mpcf_input_snd_free(i, n, xs); }
-  if (f == mpcf_trd_free)  { return mpcf_input_trd_free(i, n, xs); }
-  if (f == mpcf_strfold)   { return mpcf_input_strfold(i, n, xs); }
-  if (f == mpcf_state_ast) { return mpcf_input_state_ast(i, n, xs); }
-  for (j = 0; j < n; j++) { xs[j] = mpc_export(i, xs[j]); }
+static mpc_val_t *mpcf_input_fold_ast(mpc_input_t *i, int n, mpc_val_t **xs) {
+  
+  int j, k, m = 0;
+  size_t l;
+  mpc_ast_t **as = (mpc_ast_t**)xs;
+  mpc_ast_t *r, *c;
+  char *t;
+  
+  for (j = 0; j < n; j++) { as[j] = mpc_ast_arena_import(i->arena, as[j]); }
+  
+  if (n == 0) { return NULL; }
+  if (n == 1) { return xs[0]; }
+  if (n == 2 && xs[1] == NULL) { return xs[0]; }
+  if (n == 2 && xs[0] == NULL) { return xs[1]; }
+  
+  /* Size the children up front instead of growing them one at a time */
+  for (j = 0; j < n; j++) {
+    if (as[j] == NULL) { continue; }
+    m += as[j]->children_num ? as[j]->children_num : 1;
+  }
+  
+  r = mpc_ast_arena_node(i->arena, ">", "", m);
+  
+  for (j = 0; j < n; j++) {
+    
+    if (as[j] == NULL) { continue; }
+    
+    if (as[j]->children_num == 0) {
+      r->children[r->children_num++] = as[j];
+    } else if (as[j]->children_num == 1) {
+      c = as[j]->children[0];
+      l = strlen(as[j]->tag) - 1;
+      t = mpc_ast_arena_alloc(i->arena, l + strlen(c->tag) + 1);
+      memcpy(t, as[j]->tag, l);
+      strcpy(t + l, c->tag);
+      c->tag = t;
+      c->tagset |= as[j]->tagset;
+      r->children[r->children_num++] = c;
+    } else {
+      for (k = 0; k < as[j]->children_num; k++) {
+        r->children[r->children_num++] = as[j]->children[k];
+      }
+    }
+  
+  }
+  
+  if (r->children_num) {
+    r->state = r->children[0]->state;
+  }
+  
+  return r;
+}
+
+static mpc_val_t *mpc_parse_fold(mpc_input_t *i, mpc_fold_t f, int n, mpc_val_t **xs) {
+  int j;
+  if (f == mpcf_null)      { return mpcf_null(n, xs); }
+  if (f == mpcf_fst)       { return mpcf_fst(n, xs); }
+  if (f == mpcf_snd)       { return mpcf_snd(n, xs); }
+  if (f == mpcf_trd)       { return mpcf_trd(n, xs); }
+  if (f == mpcf_fst_free)  { return mpcf_input_fst_free(i, n, xs); }
+  if (f == mpcf_snd_free)  { return mpcf_input_snd_free(i, n, xs); }
+  if (f == mpcf_trd_free)  { return mpcf_input_trd_free(i, n, xs); }
+  if (f == mpcf_strfold)   { return mpcf_input_strfold(i, n, xs); }
+  if (f == mpcf_state_ast) { return mpcf_input_state_ast(i, n, xs); }
+  if (f == mpcf_fold_ast && i->arena) { return mpcf_input_fold_ast(i, n, xs); }
+  for (j = 0; j < n; j++) { xs[j] = mpc_export_user(i, xs[j]); }
   return f(j, xs);
 }
 
@@ -977,55 +1718,458 @@ static mpc_val_t *mpcf_input_free(mpc_input_t *i, mpc_val_t *x) {
 }
 
 static mpc_val_t *mpcf_input_str_ast(mpc_input_t *i, mpc_val_t *c) {
-  mpc_ast_t *a = mpc_ast_new("", c);
+  mpc_ast_t *a = i->arena
+    ? mpc_ast_arena_node(i->arena, "", c, 0)
+    : mpc_ast_new("", c);
   mpc_free(i, c);
   return a;
 }
 
+static mpc_val_t *mpcf_input_view_ast(mpc_input_t *i, long start, long end) {
+  mpc_ast_t *a = mpc_ast_arena_node(i->arena, "", NULL, 0);
+  a->contents = i->string + start;
+  a->contents_len = end - start;
+  return a;
+}
+
+static mpc_val_t *mpcf_input_ast_add_root(mpc_input_t *i, mpc_ast_t *a) {
+  mpc_ast_t *r;
+  a = mpc_ast_arena_import(i->arena, a);
+  if (a == NULL || a->children_num <= 1) { return a; }
+  r = mpc_ast_arena_node(i->arena, ">", "", 1);
+  r->children[r->children_num++] = a;
+  return r;
+}
+
+static mpc_val_t *mpcf_input_ast_tag(mpc_input_t *i, mpc_ast_t *a, mpc_tag_t *t) {
+  a = mpc_ast_arena_import(i->arena, a);
+  if (a == NULL) { return a; }
+  a->tag = mpc_ast_arena_alloc(i->arena, t->len + 1);
+  memcpy(a->tag, t->name, t->len + 1);
+  a->tagset = mpc_tag_bit(t->id);
+  return a;
+}
+
+static mpc_val_t *mpcf_input_ast_add_tag(mpc_input_t *i, mpc_ast_t *a, mpc_tag_t *t) {
+  char *s;
+  a = mpc_ast_arena_import(i->arena, a);
+  if (a == NULL) { return a; }
+  s = mpc_ast_arena_alloc(i->arena, t->len + 1 + strlen(a->tag) + 1);
+  memcpy(s, t->name, t->len);
+  s[t->len] = '|';
+  strcpy(s + t->len + 1, a->tag);
+  a->tag = s;
+  a->tagset |= mpc_tag_bit(t->id);
+  return a;
+}
+
 static mpc_val_t *mpc_parse_apply(mpc_input_t *i, mpc_apply_t f, mpc_val_t *x) {
   if (f == mpcf_free)     { return mpcf_input_free(i, x); }
   if (f == mpcf_str_ast)  { return mpcf_input_str_ast(i, x); }
-  return f(mpc_export(i, x));
+  if (f == (mpc_apply_t)mpc_ast_add_root && i->arena) { return mpcf_input_ast_add_root(i, x); }
+  return f(mpc_export_user(i, x));
 }
 
 static mpc_val_t *mpc_parse_apply_to(mpc_input_t *i, mpc_apply_to_t f, mpc_val_t *x, mpc_val_t *d) {
-  return f(mpc_export(i, x), d);
+  if (f == mpcf_tag_ast && i->arena)     { return mpcf_input_ast_tag(i, x, d); }
+  if (f == mpcf_add_tag_ast && i->arena) { return mpcf_input_ast_add_tag(i, x, d); }
+  return f(mpc_export_user(i, x), d);
+}
+
+static mpc_val_t *mpc_parse_copy(mpc_input_t *i, mpc_apply_t f, mpc_val_t *x) {
+  if (f == (mpc_apply_t)mpc_ast_copy && i->arena) { return mpc_ast_arena_copy(i->arena, x, 1); }
+  return f(x);
 }
 
 static void mpc_parse_dtor(mpc_input_t *i, mpc_dtor_t d, mpc_val_t *x) {
   if (d == free) { mpc_free(i, x); return; }
+  if (i->arena && mpc_ast_arena_owns(i->arena, x)) {
+    if (d == (mpc_dtor_t)mpc_ast_delete) { return; }
+    x = mpc_ast_copy(x);
+  }
   d(mpc_export(i, x));
 }
 
+/*
+** DFA matching only runs over String inputs, as
+** it looks ahead freely and then jumps straight
+** to the end of the longest match.
+*/
+
+static int mpc_input_dfa(mpc_input_t *i, mpc_pdata_dfa_t *d, char **o) {
+  
+  const unsigned char *s = (const unsigned char*)i->string + i->state.pos;
+  long j, n = i->length - i->state.pos;
+  long end = d->accept[0] ? 0 : -1;
+  int state = 0;
+  
+  for (j = 0; j < n; j++) {
+    state = d->trans[state * d->classes_num + d->classes[s[j]]];
+    if (state < 0) { break; }
+    if (d->accept[state]) { end = j + 1; }
+  }
+  
+  if (end < 0) { return 0; }
+  
+  for (j = 0; j < end; j++) {
+    i->state.col++;
+    if (s[j] == '\n') {
+      i->state.col = 0;
+      i->state.row++;
+    }
+  }
+  
+  if (end > 0) { i->last = s[end-1]; }
+  i->state.pos += end;
+  
+  if (o) {
+    *o = mpc_malloc(i, end + 1);
+    memcpy(*o, s, end);
+    (*o)[end] = '\0';
+  }
+  return 1;
+}
+
+/*
+** Memoization
+**
+** Entries are keyed on the parser and position,
+** as well as on whether errors are suppressed,
+** as that changes the errors which are built.
+** Outputs are stored as copies, since whoever
+** receives one is free to modify it.
+*/
+
+static mpc_memo_t *mpc_input_memo_slot(mpc_input_t *i, mpc_parser_t *p) {
+  unsigned long h = (unsigned long)(size_t)p / sizeof(mpc_parser_t);
+  h = (h * 31 + (unsigned long)i->state.pos) * 2654435761UL;
+  if (i->memo == NULL) {
+    i->memo = calloc(MPC_INPUT_MEMO_NUM, sizeof(mpc_memo_t));
+  }
+  return &i->memo[h % MPC_INPUT_MEMO_NUM];
+}
+
+static void mpc_input_memo_evict(mpc_input_t *i, mpc_memo_t *m) {
+  if (m->parser == NULL) { return; }
+  if (m->success) {
+    mpc_parse_dtor(i, m->parser->data.memo.dx, m->result.output);
+  } else {
+    mpc_err_delete_internal(i, m->result.error);
+  }
+  m->parser = NULL;
+}
+
+static void mpc_input_memo_clear(mpc_input_t *i) {
+  int j;
+  if (i->memo == NULL) { return; }
+  for (j = 0; j < MPC_INPUT_MEMO_NUM; j++) {
+    mpc_input_memo_evict(i, &i->memo[j]);
+  }
+  free(i->memo);
+  i->memo = NULL;
+}
+
+static int mpc_input_memo_find(mpc_input_t *i, mpc_parser_t *p, mpc_memo_t *m) {
+  return m->parser == p
+    && m->pos == i->state.pos
+    && m->suppress == (i->suppress > 0);
+}
+
+static void mpc_input_memo_replay(mpc_input_t *i, mpc_memo_t *m, mpc_result_t *r) {
+  
+  i->state = m->state;
+  i->last = m->last;
+  
+  if (i->type == MPC_INPUT_FILE) {
+    fseek(i->file, i->state.pos, SEEK_SET);
+  }
+  
+  if (m->success) {
+    r->output = mpc_parse_copy(i, m->parser->data.memo.copy, m->result.output);
+  } else {
+    r->error = mpc_err_copy(i, m->result.error);
+  }
+}
+
+static void mpc_input_memo_store(mpc_input_t *i, mpc_parser_t *p, mpc_memo_t *m,
+  long pos, int suppress, int success, mpc_result_t *r) {
+  
+  mpc_input_memo_evict(i, m);
+  
+  m->parser = p;
+  m->pos = pos;
+  m->suppress = suppress;
+  m->success = success;
+  m->state = i->state;
+  m->last = i->last;
+  
+  if (success) {
+    r->output = mpc_export(i, r->output);
+    m->result.output = mpc_parse_copy(i, p->data.memo.copy, r->output);
+  } else {
+    m->result.error = mpc_err_copy(i, r->error);
+  }
+}
+
+/*
+** Parse Frames
+**
+** Parsers are run from an explicit stack of frames
+** kept on the input rather than by recursion, so the
+** depth of the input is only limited by memory. A
+** frame is entered once, and then resumed with the
+** result of each child it calls, until it returns.
+**
+** Only parsers which can lead back into a rule can
+** nest as deeply as the input does. Tokens, and the
+** expect and apply wrappers around them, are run
+** directly without a frame of their own, as their
+** depth is fixed by the grammar.
+*/
+
+static mpc_frame_t *mpc_frame_push(mpc_input_t *i, mpc_parser_t *p) {
+  
+  mpc_frame_t *f;
+  
+  if (i->frames_num == i->frames_slots) {
+    i->frames_slots = i->frames_slots ? i->frames_slots * 2 : MPC_INPUT_FRAMES_MIN;
+    i->frames = realloc(i->frames, sizeof(mpc_frame_t) * i->frames_slots);
+  }
+  
+  f = &i->frames[i->frames_num++];
+  f->parser = p;
+  f->j = 0;
+  f->results = NULL;
+  f->pos = i->state.pos;
+  return f;
+}
+
+static void mpc_frame_add(mpc_input_t *i, mpc_frame_t *f, mpc_result_t x) {
+  if (f->j < MPC_PARSE_STACK_MIN) {
+    f->results_stk[f->j++] = x;
+    return;
+  }
+  if (f->j == MPC_PARSE_STACK_MIN) {
+    f->results_slots = f->j + f->j / 2;
+    f->results = mpc_malloc(i, sizeof(mpc_result_t) * f->results_slots);
+    memcpy(f->results, f->results_stk, sizeof(mpc_result_t) * MPC_PARSE_STACK_MIN);
+  } else if (f->j == f->results_slots) {
+    f->results_slots = f->j + f->j / 2;
+    f->results = mpc_realloc(i, f->results, sizeof(mpc_result_t) * f->results_slots);
+  }
+  f->results[f->j++] = x;
+}
+
+/* Results live in the frame itself until there are too many of them */
+static mpc_result_t *mpc_frame_results(mpc_frame_t *f) {
+  return f->results ? f->results : f->results_stk;
+}
+
+static mpc_val_t *mpc_frame_fold(mpc_input_t *i, mpc_frame_t *f, mpc_fold_t fold) {
+  mpc_val_t *x = mpc_parse_fold(i, fold, f->j, (mpc_val_t**)mpc_frame_results(f));
+  if (f->results) { mpc_free(i, f->results); }
+  return x;
+}
+
+static void mpc_frame_dtors(mpc_input_t *i, mpc_frame_t *f, mpc_dtor_t d, mpc_dtor_t *ds) {
+  int k;
+  for (k = 0; k < f->j; k++) {
+    mpc_parse_dtor(i, ds ? ds[k] : d, mpc_frame_results(f)[k].output);
+  }
+  if (f->results) { mpc_free(i, f->results); }
+}
+
+/*
+** The earliest position any frame on the stack can
+** read from again after a failure. A repetition
+** reads on from the start of its latest attempt.
+** Leaf parsers such as strings rewind to a mark of
+** their own without a frame, which is always the
+** newest mark while they run.
+*/
+
+static long mpc_input_floor(mpc_input_t *i) {
+  
+  int k;
+  long pos = i->state.pos;
+  
+  for (k = 0; k < i->frames_num; k++) {
+    switch (i->frames[k].parser->type) {
+      case MPC_TYPE_EXPECT:
+      case MPC_TYPE_JUMP:
+      case MPC_TYPE_NOT:
+      case MPC_TYPE_MAYBE:
+      case MPC_TYPE_MANY:
+      case MPC_TYPE_MANY1:
+      case MPC_TYPE_OR:
+        if (i->frames[k].pos < pos) { pos = i->frames[k].pos; }
+        break;
+      default: break;
+    }
+  }
+  
+  if (i->marks_num > 0 && i->marks[i->marks_num-1].pos < pos) {
+    pos = i->marks[i->marks_num-1].pos;
+  }
+  
+  return pos;
+}
+
+static int mpc_parse_simple(mpc_parser_t *p) {
+  while (1) {
+    switch (p->type) {
+      case MPC_TYPE_EXPECT:   p = p->data.expect.x; break;
+      case MPC_TYPE_APPLY:    p = p->data.apply.x; break;
+      case MPC_TYPE_APPLY_TO: p = p->data.apply_to.x; break;
+      case MPC_TYPE_DFA:      return 1;
+      default:                return p->type < MPC_TYPE_APPLY;
+    }
+  }
+}
+
+static int mpc_parse_run(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r, mpc_err_t **e);
+
+/*
+** Views
+**
+** When parsing into a views arena, a token under
+** mpcf_str_ast is matched without building any
+** output, and its leaf records where it started
+** and ended in the input. A token here is a match
+** whose output would be exactly the text consumed:
+** terminals, regexes, their expectations and
+** string folds of them, optionally followed by
+** skipped blanks as mpc_tok adds. Anything else,
+** such as a transforming apply, is built and then
+** copied as before. Errors are suppressed on the
+** first pass over a String, so views are only made
+** then, leaving the exact pass unchanged.
+*/
+
 enum {
-  MPC_PARSE_STACK_MIN = 4
+  MPC_VIEW_DEPTH = 8
 };
 
-#define MPC_SUCCESS(x) r->output = x; return 1
-#define MPC_FAILURE(x) r->error = x; return 0
-#define MPC_PRIMITIVE(x) \
-  if (x) { MPC_SUCCESS(r->output); } \
+/* Whether p outputs only the text it matched, or nothing when not keep */
+static int mpc_view_text(mpc_parser_t *p, int keep, int depth) {
+  
+  if (depth > MPC_VIEW_DEPTH) { return 0; }
+  
+  switch (p->type) {
+    case MPC_TYPE_ANY:
+    case MPC_TYPE_SINGLE:
+    case MPC_TYPE_RANGE:
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+    case MPC_TYPE_SATISFY:
+    case MPC_TYPE_STRING:
+    case MPC_TYPE_DFA:
+      return 1;
+    case MPC_TYPE_EXPECT:
+      return mpc_view_text(p->data.expect.x, keep, depth+1);
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+      return p->data.repeat.f == mpcf_strfold
+        && mpc_view_text(p->data.repeat.x, keep, depth+1);
+    case MPC_TYPE_APPLY:
+      return !keep && p->data.apply.f == mpcf_free
+        && mpc_view_text(p->data.apply.x, keep, depth+1);
+    default:
+      return 0;
+  }
+}
+
+/* Matches a parser for which mpc_view_text holds, without output */
+static int mpc_view_match(mpc_input_t *i, mpc_parser_t *p) {
+  
+  int n = 0;
+  mpc_result_t r;
+  mpc_err_t *e = NULL;
+  
+  switch (p->type) {
+    case MPC_TYPE_ANY:     return mpc_input_any(i, NULL);
+    case MPC_TYPE_SINGLE:  return mpc_input_char(i, p->data.single.x, NULL);
+    case MPC_TYPE_RANGE:   return mpc_input_range(i, p->data.range.x, p->data.range.y, NULL);
+    case MPC_TYPE_ONEOF:   return mpc_input_oneof(i, p->data.string.x, NULL);
+    case MPC_TYPE_NONEOF:  return mpc_input_noneof(i, p->data.string.x, NULL);
+    case MPC_TYPE_SATISFY: return mpc_input_satisfy(i, p->data.satisfy.f, NULL);
+    case MPC_TYPE_STRING:  return mpc_input_string(i, p->data.string.x, NULL);
+    case MPC_TYPE_EXPECT:  return mpc_view_match(i, p->data.expect.x);
+    case MPC_TYPE_APPLY:   return mpc_view_match(i, p->data.apply.x);
+    
+    case MPC_TYPE_DFA:
+      if (mpc_input_dfa(i, &p->data.dfa, NULL)) { return 1; }
+      if (!mpc_parse_run(i, p->data.dfa.x, &r, &e)) { return 0; }
+      mpc_free(i, r.output);
+      return 1;
+    
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+      while (mpc_view_match(i, p->data.repeat.x)) { n++; }
+      return p->type == MPC_TYPE_MANY || n > 0;
+    
+    default: return 0;
+  }
+}
+
+/* Runs the child of mpcf_str_ast as a view, or returns -1 if it cannot */
+static int mpc_parse_view(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *y) {
+  
+  long start, end;
+  mpc_parser_t *blank = NULL;
+  
+  if (!mpc_input_views(i) || i->exact) { return -1; }
+  
+  if (p->type == MPC_TYPE_AND && p->data.and.n == 2
+  && (p->data.and.f == mpcf_fst || p->data.and.f == mpcf_fst_free)
+  && mpc_view_text(p->data.and.xs[1], 0, 0)) {
+    blank = p->data.and.xs[1];
+    p = p->data.and.xs[0];
+  }
+  
+  if (!mpc_view_text(p, 1, 0)) { return -1; }
+  
+  start = i->state.pos;
+  y->error = NULL;
+  if (!mpc_view_match(i, p)) { return 0; }
+  end = i->state.pos;
+  
+  if (blank) {
+    mpc_input_mark(i);
+    if (!mpc_view_match(i, blank)) {
+      mpc_input_rewind(i);
+      return 0;
+    }
+    mpc_input_unmark(i);
+  }
+  
+  y->output = mpcf_input_view_ast(i, start, end);
+  return 1;
+}
+
+#define MPC_SUCCESS(v) { y->output = (v); return 1; }
+#define MPC_FAILURE(v) { y->error = (v); return 0; }
+#define MPC_PRIMITIVE(t) \
+  if (t) { MPC_SUCCESS(y->output); } \
   else { MPC_FAILURE(NULL); }
 
-static int mpc_parse_run(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r, mpc_err_t **e) {
+/* Runs a parser for which mpc_parse_simple holds */
+static int mpc_parse_leaf(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *y, mpc_err_t **e) {
   
-  int j = 0, k = 0;
-  mpc_result_t results_stk[MPC_PARSE_STACK_MIN];
-  mpc_result_t *results;
-  int results_slots = MPC_PARSE_STACK_MIN;
+  int x;
   
   switch (p->type) {
-      
+    
     /* Basic Parsers */
-
-    case MPC_TYPE_ANY:     MPC_PRIMITIVE(mpc_input_any(i, (char**)&r->output));
-    case MPC_TYPE_SINGLE:  MPC_PRIMITIVE(mpc_input_char(i, p->data.single.x, (char**)&r->output));
-    case MPC_TYPE_RANGE:   MPC_PRIMITIVE(mpc_input_range(i, p->data.range.x, p->data.range.y, (char**)&r->output));
-    case MPC_TYPE_ONEOF:   MPC_PRIMITIVE(mpc_input_oneof(i, p->data.string.x, (char**)&r->output));
-    case MPC_TYPE_NONEOF:  MPC_PRIMITIVE(mpc_input_noneof(i, p->data.string.x, (char**)&r->output));
-    case MPC_TYPE_SATISFY: MPC_PRIMITIVE(mpc_input_satisfy(i, p->data.satisfy.f, (char**)&r->output));
-    case MPC_TYPE_STRING:  MPC_PRIMITIVE(mpc_input_string(i, p->data.string.x, (char**)&r->output));
-    case MPC_TYPE_ANCHOR:  MPC_PRIMITIVE(mpc_input_anchor(i, p->data.anchor.f, (char**)&r->output));
+    
+    case MPC_TYPE_ANY:     MPC_PRIMITIVE(mpc_input_any(i, (char**)&y->output));
+    case MPC_TYPE_SINGLE:  MPC_PRIMITIVE(mpc_input_char(i, p->data.single.x, (char**)&y->output));
+    case MPC_TYPE_RANGE:   MPC_PRIMITIVE(mpc_input_range(i, p->data.range.x, p->data.range.y, (char**)&y->output));
+    case MPC_TYPE_ONEOF:   MPC_PRIMITIVE(mpc_input_oneof(i, p->data.string.x, (char**)&y->output));
+    case MPC_TYPE_NONEOF:  MPC_PRIMITIVE(mpc_input_noneof(i, p->data.string.x, (char**)&y->output));
+    case MPC_TYPE_SATISFY: MPC_PRIMITIVE(mpc_input_satisfy(i, p->data.satisfy.f, (char**)&y->output));
+    case MPC_TYPE_STRING:  MPC_PRIMITIVE(mpc_input_string(i, p->data.string.x, (char**)&y->output));
+    case MPC_TYPE_ANCHOR:  MPC_PRIMITIVE(mpc_input_anchor(i, p->data.anchor.f, (char**)&y->output));
     
     /* Other parsers */
     
@@ -1039,205 +2183,313 @@ static int mpc_parse_run(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r, mpc_e
     /* Application Parsers */
     
     case MPC_TYPE_APPLY:
-      if (mpc_parse_run(i, p->data.apply.x, r, e)) {
-        MPC_SUCCESS(mpc_parse_apply(i, p->data.apply.f, r->output));
-      } else {
-        MPC_FAILURE(r->output);
+      if (p->data.apply.f == mpcf_str_ast
+      && (x = mpc_parse_view(i, p->data.apply.x, y)) >= 0) {
+        return x;
       }
+      if (!mpc_parse_leaf(i, p->data.apply.x, y, e)) { return 0; }
+      MPC_SUCCESS(mpc_parse_apply(i, p->data.apply.f, y->output));
     
     case MPC_TYPE_APPLY_TO:
-      if (mpc_parse_run(i, p->data.apply_to.x, r, e)) {
-        MPC_SUCCESS(mpc_parse_apply_to(i, p->data.apply_to.f, r->output, p->data.apply_to.d));
-      } else {
-        MPC_FAILURE(r->error);
-      }
+      if (!mpc_parse_leaf(i, p->data.apply_to.x, y, e)) { return 0; }
+      MPC_SUCCESS(mpc_parse_apply_to(i, p->data.apply_to.f, y->output, p->data.apply_to.d));
     
     case MPC_TYPE_EXPECT:
       mpc_input_suppress_enable(i);
-      if (mpc_parse_run(i, p->data.expect.x, r, e)) {
-        mpc_input_suppress_disable(i);
-        MPC_SUCCESS(r->output);
-      } else {
-        mpc_input_suppress_disable(i);
-        MPC_FAILURE(mpc_err_new(i, p->data.expect.m));
-      }
-    
-    case MPC_TYPE_PREDICT:
-      mpc_input_backtrack_disable(i);
-      if (mpc_parse_run(i, p->data.predict.x, r, e)) {      
-        mpc_input_backtrack_enable(i);
-        MPC_SUCCESS(r->output);
-      } else {
-        mpc_input_backtrack_enable(i);
-        MPC_FAILURE(r->error);
-      }
-    
-    /* Optional Parsers */
-    
-    /* TODO: Update Not Error Message */
-    
-    case MPC_TYPE_NOT:
-      mpc_input_mark(i);
-      mpc_input_suppress_enable(i);
-      if (mpc_parse_run(i, p->data.not.x, r, e)) {
-        mpc_input_rewind(i);
+      if (mpc_parse_leaf(i, p->data.expect.x, y, e)) {
         mpc_input_suppress_disable(i);
-        mpc_parse_dtor(i, p->data.not.dx, r->output);
-        MPC_FAILURE(mpc_err_new(i, "opposite"));
-      } else {
-        mpc_input_unmark(i);
-        mpc_input_suppress_disable(i);
-        MPC_SUCCESS(p->data.not.lf());
+        return 1;
       }
+      mpc_input_suppress_disable(i);
+      MPC_FAILURE(mpc_err_new(i, p->data.expect.m));
     
-    case MPC_TYPE_MAYBE:
-      if (mpc_parse_run(i, p->data.not.x, r, e)) {
-        MPC_SUCCESS(r->output);
-      } else {
-        *e = mpc_err_merge(i, *e, r->error);
-        MPC_SUCCESS(p->data.not.lf());
-      }
+    /* The combinators of a regex never lead back into a rule */
     
-    /* Repeat Parsers */
-    
-    case MPC_TYPE_MANY:
-      
-      results = results_stk;
-      
-      while (mpc_parse_run(i, p->data.repeat.x, &results[j], e)) {
-        j++;
-        if (j == MPC_PARSE_STACK_MIN) {
-          results_slots = j + j / 2;
-          results = mpc_malloc(i, sizeof(mpc_result_t) * results_slots);
-          memcpy(results, results_stk, sizeof(mpc_result_t) * MPC_PARSE_STACK_MIN);
-        } else if (j >= results_slots) {
-          results_slots = j + j / 2;
-          results = mpc_realloc(i, results, sizeof(mpc_result_t) * results_slots);
-        }
+    case MPC_TYPE_DFA:
+      if (i->type == MPC_INPUT_STRING && !i->exact
+      &&  mpc_input_dfa(i, &p->data.dfa, (char**)&y->output)) {
+        MPC_SUCCESS(y->output);
       }
-      
-      *e = mpc_err_merge(i, *e, results[j].error);
-      MPC_SUCCESS(
-        mpc_parse_fold(i, p->data.repeat.f, j, (mpc_val_t**)results);
-        if (j >= MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
+      return mpc_parse_run(i, p->data.dfa.x, y, e);
     
-    case MPC_TYPE_MANY1:
-      
-      results = results_stk;
-      
-      while (mpc_parse_run(i, p->data.repeat.x, &results[j], e)) {
-        j++;
-        if (j == MPC_PARSE_STACK_MIN) {
-          results_slots = j + j / 2;
-          results = mpc_malloc(i, sizeof(mpc_result_t) * results_slots);
-          memcpy(results, results_stk, sizeof(mpc_result_t) * MPC_PARSE_STACK_MIN);
-        } else if (j >= results_slots) {
-          results_slots = j + j / 2;
-          results = mpc_realloc(i, results, sizeof(mpc_result_t) * results_slots);
-        }
-      }
-      
-      if (j == 0) {
-        MPC_FAILURE(
-          mpc_err_many1(i, results[j].error);
-          if (j >= MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-      } else {
-        *e = mpc_err_merge(i, *e, results[j].error);
-        MPC_SUCCESS(
-          mpc_parse_fold(i, p->data.repeat.f, j, (mpc_val_t**)results);
-          if (j >= MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-      }
+    default:
+      MPC_FAILURE(mpc_err_fail(i, "Unknown Parser Type Id!"));
+  }
+  
+}
+
+#undef MPC_SUCCESS
+#undef MPC_FAILURE
+#undef MPC_PRIMITIVE
+
+#define MPC_CALL(q) { \
+  if (mpc_parse_simple(q)) { x = mpc_parse_leaf(i, q, &y, e); enter = 0; } \
+  else { mpc_frame_push(i, q); enter = 1; } \
+  continue; }
+#define MPC_TAIL(q) { i->frames_num--; MPC_CALL(q); }
+#define MPC_SUCCESS(v) { y.output = (v); x = 1; break; }
+#define MPC_FAILURE(v) { y.error = (v); x = 0; break; }
+
+static int mpc_parse_run(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r, mpc_err_t **e) {
+  
+  int base = i->frames_num;
+  int enter = 1;
+  int x = 0;
+  mpc_result_t y;
+  mpc_frame_t *f;
+  
+  y.output = NULL;
+  mpc_frame_push(i, p);
+  
+  while (i->frames_num > base) {
     
-    case MPC_TYPE_COUNT:
-      
-      results = p->data.repeat.n > MPC_PARSE_STACK_MIN
-        ? mpc_malloc(i, sizeof(mpc_result_t) * p->data.repeat.n)
-        : results_stk;
-      
-      while (mpc_parse_run(i, p->data.repeat.x, &results[j], e)) {
-        j++;
-        if (j == p->data.repeat.n) { break; }
-      }
-      
-      if (j == p->data.repeat.n) {
-        MPC_SUCCESS(
-          mpc_parse_fold(i, p->data.repeat.f, j, (mpc_val_t**)results);
-          if (p->data.repeat.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-      } else {
-        for (k = 0; k < j; k++) {
-          mpc_parse_dtor(i, p->data.repeat.dx, results[k].output);
-        }
-        MPC_FAILURE(
-          mpc_err_count(i, results[j].error, p->data.repeat.n);
-          if (p->data.repeat.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });  
-      }
-      
-    /* Combinatory Parsers */
+    /* Running a leaf can move the frames, so look again each time */
+    f = &i->frames[i->frames_num-1];
+    p = f->parser;
     
-    case MPC_TYPE_OR:
-      
-      if (p->data.or.n == 0) { MPC_SUCCESS(NULL); }
-      
-      results = p->data.or.n > MPC_PARSE_STACK_MIN
-        ? mpc_malloc(i, sizeof(mpc_result_t) * p->data.or.n)
-        : results_stk;
+    if (enter) {
       
-      for (j = 0; j < p->data.or.n; j++) {
-        if (mpc_parse_run(i, p->data.or.xs[j], &results[j], e)) {
-          MPC_SUCCESS(results[j].output;
-            if (p->data.or.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-        } else {
-          *e = mpc_err_merge(i, *e, results[j].error);
-        } 
+      switch (p->type) {
+        
+        /* Application Parsers */
+        
+        case MPC_TYPE_APPLY:
+          if (p->data.apply.f == mpcf_str_ast
+          && (x = mpc_parse_view(i, p->data.apply.x, &y)) >= 0) {
+            break;
+          }
+          MPC_CALL(p->data.apply.x);
+        case MPC_TYPE_APPLY_TO: MPC_CALL(p->data.apply_to.x);
+        
+        case MPC_TYPE_EXPECT:
+          mpc_input_suppress_enable(i);
+          MPC_CALL(p->data.expect.x);
+        
+        case MPC_TYPE_PREDICT:
+          mpc_input_backtrack_disable(i);
+          MPC_CALL(p->data.predict.x);
+        
+        case MPC_TYPE_MEMO:
+          if (i->backtrack < 1) { MPC_TAIL(p->data.memo.x); }
+          p->data.memo.lookups++;
+          f->memo = mpc_input_memo_slot(i, p);
+          if (mpc_input_memo_find(i, p, f->memo)) {
+            p->data.memo.hits++;
+            mpc_input_memo_replay(i, f->memo, &y);
+            x = f->memo->success;
+            break;
+          }
+          f->k = i->suppress > 0;
+          MPC_CALL(p->data.memo.x);
+        
+        case MPC_TYPE_JUMP:
+          if (i->type != MPC_INPUT_STRING || i->exact || i->state.pos >= i->length
+          || (f->j = p->data.jump.start[(unsigned char)i->string[i->state.pos]]) == 0) {
+            MPC_TAIL(p->data.jump.x);
+          }
+          if (f->j == p->data.jump.x->data.or.n) { MPC_FAILURE(NULL); }
+          MPC_CALL(p->data.jump.x->data.or.xs[f->j]);
+        
+        /* Optional Parsers */
+        
+        case MPC_TYPE_NOT:
+          mpc_input_mark(i);
+          mpc_input_suppress_enable(i);
+          MPC_CALL(p->data.not.x);
+        
+        case MPC_TYPE_MAYBE:
+          MPC_CALL(p->data.not.x);
+        
+        /* Repeat Parsers */
+        
+        case MPC_TYPE_MANY:
+        case MPC_TYPE_MANY1:
+        case MPC_TYPE_COUNT:
+          MPC_CALL(p->data.repeat.x);
+        
+        /* Combinatory Parsers */
+        
+        case MPC_TYPE_OR:
+          if (p->data.or.n == 0) { MPC_SUCCESS(NULL); }
+          MPC_CALL(p->data.or.xs[0]);
+        
+        case MPC_TYPE_AND:
+          if (p->data.and.n == 0) { MPC_SUCCESS(NULL); }
+          mpc_input_mark(i);
+          MPC_CALL(p->data.and.xs[0]);
+        
+        /* Basic and Other Parsers */
+        
+        default:
+          x = mpc_parse_leaf(i, p, &y, e);
+          break;
       }
-      
-      MPC_FAILURE(NULL;
-        if (p->data.or.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
     
-    case MPC_TYPE_AND:
-      
-      if (p->data.and.n == 0) { MPC_SUCCESS(NULL); }
+    } else {
       
-      results = p->data.or.n > MPC_PARSE_STACK_MIN
-        ? mpc_malloc(i, sizeof(mpc_result_t) * p->data.or.n)
-        : results_stk;
+      /* Resumed with the result of a child in x and y */
       
-      mpc_input_mark(i);
-      for (j = 0; j < p->data.and.n; j++) {
-        if (!mpc_parse_run(i, p->data.and.xs[j], &results[j], e)) {
-          mpc_input_rewind(i);
-          for (k = 0; k < j; k++) {
-            mpc_parse_dtor(i, p->data.and.dxs[k], results[k].output);
+      switch (p->type) {
+        
+        case MPC_TYPE_APPLY:
+          if (!x) { break; }
+          MPC_SUCCESS(mpc_parse_apply(i, p->data.apply.f, y.output));
+        
+        case MPC_TYPE_APPLY_TO:
+          if (!x) { break; }
+          MPC_SUCCESS(mpc_parse_apply_to(i, p->data.apply_to.f, y.output, p->data.apply_to.d));
+        
+        case MPC_TYPE_EXPECT:
+          mpc_input_suppress_disable(i);
+          if (x) { break; }
+          MPC_FAILURE(mpc_err_new(i, p->data.expect.m));
+        
+        case MPC_TYPE_PREDICT:
+          mpc_input_backtrack_enable(i);
+          break;
+        
+        case MPC_TYPE_MEMO:
+          mpc_input_memo_store(i, p, f->memo, f->pos, f->k, x, &y);
+          break;
+        
+        case MPC_TYPE_JUMP:
+          if (x) { break; }
+          *e = mpc_err_merge(i, *e, y.error);
+          if (++f->j < p->data.jump.x->data.or.n) {
+            MPC_CALL(p->data.jump.x->data.or.xs[f->j]);
           }
-          MPC_FAILURE(results[j].error;
-            if (p->data.or.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
-        }
+          MPC_FAILURE(NULL);
+        
+        /* TODO: Update Not Error Message */
+        
+        case MPC_TYPE_NOT:
+          if (x) {
+            mpc_input_rewind(i);
+            mpc_input_suppress_disable(i);
+            mpc_parse_dtor(i, p->data.not.dx, y.output);
+            MPC_FAILURE(mpc_err_new(i, "opposite"));
+          }
+          mpc_input_unmark(i);
+          mpc_input_suppress_disable(i);
+          MPC_SUCCESS(p->data.not.lf());
+        
+        case MPC_TYPE_MAYBE:
+          if (x) { break; }
+          *e = mpc_err_merge(i, *e, y.error);
+          MPC_SUCCESS(p->data.not.lf());
+        
+        case MPC_TYPE_MANY:
+          if (x) {
+            mpc_frame_add(i, f, y);
+            f->pos = i->state.pos;
+            MPC_CALL(p->data.repeat.x);
+          }
+          *e = mpc_err_merge(i, *e, y.error);
+          MPC_SUCCESS(mpc_frame_fold(i, f, p->data.repeat.f));
+        
+        case MPC_TYPE_MANY1:
+          if (x) {
+            mpc_frame_add(i, f, y);
+            f->pos = i->state.pos;
+            MPC_CALL(p->data.repeat.x);
+          }
+          if (f->j == 0) {
+            MPC_FAILURE(mpc_err_many1(i, y.error));
+          }
+          *e = mpc_err_merge(i, *e, y.error);
+          MPC_SUCCESS(mpc_frame_fold(i, f, p->data.repeat.f));
+        
+        case MPC_TYPE_COUNT:
+          if (x) {
+            mpc_frame_add(i, f, y);
+            if (f->j != p->data.repeat.n) { MPC_CALL(p->data.repeat.x); }
+          }
+          if (f->j == p->data.repeat.n) {
+            MPC_SUCCESS(mpc_frame_fold(i, f, p->data.repeat.f));
+          }
+          mpc_frame_dtors(i, f, p->data.repeat.dx, NULL);
+          MPC_FAILURE(mpc_err_count(i, y.error, p->data.repeat.n));
+        
+        case MPC_TYPE_OR:
+          if (x) { break; }
+          *e = mpc_err_merge(i, *e, y.error);
+          if (++f->j < p->data.or.n) { MPC_CALL(p->data.or.xs[f->j]); }
+          MPC_FAILURE(NULL);
+        
+        case MPC_TYPE_AND:
+          if (!x) {
+            mpc_input_rewind(i);
+            mpc_frame_dtors(i, f, NULL, p->data.and.dxs);
+            break;
+          }
+          mpc_frame_add(i, f, y);
+          if (f->j < p->data.and.n) { MPC_CALL(p->data.and.xs[f->j]); }
+          mpc_input_unmark(i);
+          MPC_SUCCESS(mpc_frame_fold(i, f, p->data.and.f));
+        
+        default: break;
       }
-      mpc_input_unmark(i); 
-      MPC_SUCCESS(
-        mpc_parse_fold(i, p->data.and.f, j, (mpc_val_t**)results);
-        if (p->data.or.n > MPC_PARSE_STACK_MIN) { mpc_free(i, results); });
     
-    /* End */
+    }
     
-    default:
-      
-      MPC_FAILURE(mpc_err_fail(i, "Unknown Parser Type Id!"));
+    /* Return the result in x and y to the frame below */
+    i->frames_num--;
+    enter = 0;
   }
   
-  return 0;
+  /* Only small stacks are kept around for the next parse */
+  if (base == 0 && i->frames_slots > MPC_INPUT_FRAMES_KEEP) {
+    free(i->frames);
+    i->frames = NULL;
+    i->frames_slots = 0;
+  }
   
+  *r = y;
+  return x;
 }
 
+#undef MPC_CALL
+#undef MPC_TAIL
 #undef MPC_SUCCESS
 #undef MPC_FAILURE
-#undef MPC_PRIMITIVE
 
 int mpc_parse_input(mpc_input_t *i, mpc_parser_t *p, mpc_result_t *r) {
   int x;
-  mpc_err_t *e = mpc_err_fail(i, "Unknown Error");
+  mpc_state_t start = i->state;
+  char last = i->last;
+  mpc_err_t *e = NULL;
+  
+  /*
+  ** Errors are only ever read when the whole parse
+  ** fails, so a String input is first parsed with all
+  ** of them suppressed, and with the DFA matches and
+  ** jumps past alternatives that skip them. Only if
+  ** that fails is it parsed again, exactly, to build
+  ** the errors the combinators would have recorded.
+  ** Callbacks run again too, as mpc.h warns.
+  */
+  if (i->type == MPC_INPUT_STRING && !i->exact) {
+    
+    mpc_input_suppress_enable(i);
+    x = mpc_parse_run(i, p, r, &e);
+    mpc_input_suppress_disable(i);
+    
+    if (x) {
+      r->output = mpc_export(i, r->output);
+      return x;
+    }
+    
+    mpc_err_delete_internal(i, mpc_err_merge(i, e, r->error));
+    mpc_input_memo_clear(i);
+    i->state = start;
+    i->last = last;
+    i->exact = 1;
+  }
+  
+  e = mpc_err_fail(i, "Unknown Error");
   e->state = mpc_state_invalid();
   x = mpc_parse_run(i, p, r, &e);
+  
   if (x) {
     mpc_err_delete_internal(i, e);
     r->output = mpc_export(i, r->output);
@@ -1279,22 +2531,130 @@ int mpc_parse_pipe(const char *filename, FILE *pipe, mpc_parser_t *p, mpc_result
   return x;
 }
 
-int mpc_parse_contents(const char *filename, mpc_parser_t *p, mpc_result_t *r) {
+static int mpc_parse_contents_st(const char *filename, mpc_parser_t *p, mpc_result_t *r, mpc_ast_arena_t *a) {
   
-  FILE *f = fopen(filename, "rb");
+  FILE *f = NULL;
   int res;
+  mpc_input_t *i = mpc_input_new_mmap(filename);
   
-  if (f == NULL) {
-    r->output = NULL;
-    r->error = mpc_err_file(filename, "Unable to open file!");
-    return 0;
+  if (i == NULL) {
+    
+    f = fopen(filename, "rb");
+    
+    if (f == NULL) {
+      r->output = NULL;
+      r->error = mpc_err_file(filename, "Unable to open file!");
+      return 0;
+    }
+    
+    i = mpc_input_new_file(filename, f);
   }
   
-  res = mpc_parse_file(filename, f, p, r);
-  fclose(f);
+  i->arena = a;
+  res = mpc_parse_input(i, p, r);
+  mpc_ast_arena_keep(i);
+  mpc_input_delete(i);
+  if (f) { fclose(f); }
   return res;
 }
 
+int mpc_parse_contents(const char *filename, mpc_parser_t *p, mpc_result_t *r) {
+  return mpc_parse_contents_st(filename, p, r, NULL);
+}
+
+int mpc_parse_arena(const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r, mpc_ast_arena_t *a) {
+  int x;
+  mpc_input_t *i = mpc_input_new_string(filename, string);
+  i->arena = a;
+  x = mpc_parse_input(i, p, r);
+  mpc_ast_arena_keep(i);
+  mpc_input_delete(i);
+  return x;
+}
+
+int mpc_parse_contents_arena(const char *filename, mpc_parser_t *p, mpc_result_t *r, mpc_ast_arena_t *a) {
+  return mpc_parse_contents_st(filename, p, r, a);
+}
+
+/*
+** Parse Contexts
+**
+** A context keeps one input around between parses so
+** that its pool, marks and filename are only set up
+** once. The string being parsed is borrowed from the
+** caller for the length of the call, unless a views
+** arena needs to keep it afterwards.
+*/
+
+struct mpc_context_t {
+  mpc_input_t *input;
+};
+
+mpc_context_t *mpc_context_new(const char *filename) {
+  mpc_context_t *c = malloc(sizeof(mpc_context_t));
+  c->input = mpc_input_new_string(filename, "");
+  free(c->input->string);
+  c->input->string = NULL;
+  return c;
+}
+
+void mpc_context_delete(mpc_context_t *c) {
+  mpc_input_delete(c->input);
+  free(c);
+}
+
+static void mpc_input_reset(mpc_input_t *i) {
+  
+  mpc_input_memo_clear(i);
+  
+  mpc_pool_hits += i->pool_hits;
+  mpc_pool_misses += i->pool_misses;
+  i->pool_hits = 0;
+  i->pool_misses = 0;
+  if (i->pool) { mpc_pool_reset(i); }
+  
+  i->state = mpc_state_new();
+  i->suppress = 0;
+  i->backtrack = 1;
+  i->marks_num = 0;
+  i->last = '\0';
+  i->arena = NULL;
+  i->exact = 0;
+}
+
+static int mpc_parse_context_st(mpc_context_t *c, const char *string, mpc_parser_t *p, mpc_result_t *r, mpc_ast_arena_t *a) {
+  
+  int x;
+  mpc_input_t *i = c->input;
+  
+  mpc_input_reset(i);
+  i->arena = a;
+  i->length = strlen(string);
+  
+  if (mpc_input_views(i)) {
+    i->string = malloc(i->length + 1);
+    memcpy(i->string, string, i->length + 1);
+  } else {
+    i->string = (char*)string;
+  }
+  
+  x = mpc_parse_input(i, p, r);
+  mpc_ast_arena_keep(i);
+  mpc_input_reset(i);
+  
+  i->string = NULL;
+  i->length = 0;
+  return x;
+}
+
+int mpc_parse_context(mpc_context_t *c, const char *string, mpc_parser_t *p, mpc_result_t *r) {
+  return mpc_parse_context_st(c, string, p, r, NULL);
+}
+
+int mpc_parse_context_arena(mpc_context_t *c, const char *string, mpc_parser_t *p, mpc_result_t *r, mpc_ast_arena_t *a) {
+  return mpc_parse_context_st(c, string, p, r, a);
+}
+
 /*
 ** Building a Parser
 */
@@ -1324,7 +2684,7 @@ static void mpc_undefine_and(mpc_parser_t *p) {
 
 static void mpc_undefine_unretained(mpc_parser_t *p, int force) {
   
-  if (p->retained && !force) { return; }
+  if (p == NULL || (p->retained && !force)) { return; }
   
   switch (p->type) {
     
@@ -1339,6 +2699,19 @@ static void mpc_undefine_unretained(mpc_parser_t *p, int force) {
     case MPC_TYPE_APPLY:    mpc_undefine_unretained(p->data.apply.x, 0);    break;
     case MPC_TYPE_APPLY_TO: mpc_undefine_unretained(p->data.apply_to.x, 0); break;
     case MPC_TYPE_PREDICT:  mpc_undefine_unretained(p->data.predict.x, 0);  break;
+    case MPC_TYPE_MEMO:     mpc_undefine_unretained(p->data.memo.x, 0);     break;
+    
+    case MPC_TYPE_DFA:
+      mpc_undefine_unretained(p->data.dfa.x, 0);
+      free(p->data.dfa.classes);
+      free(p->data.dfa.accept);
+      free(p->data.dfa.trans);
+      break;
+    
+    case MPC_TYPE_JUMP:
+      mpc_undefine_unretained(p->data.jump.x, 0);
+      free(p->data.jump.start);
+      break;
     
     case MPC_TYPE_MAYBE:
     case MPC_TYPE_NOT:
@@ -1438,6 +2811,28 @@ mpc_parser_t *mpc_copy(mpc_parser_t *a) {
     case MPC_TYPE_APPLY_TO: p->data.apply_to.x = mpc_copy(a->data.apply_to.x); break;
     case MPC_TYPE_PREDICT:  p->data.predict.x  = mpc_copy(a->data.predict.x);  break;
     
+    case MPC_TYPE_MEMO:
+      p->data.memo.x = mpc_copy(a->data.memo.x);
+      p->data.memo.lookups = 0;
+      p->data.memo.hits = 0;
+      break;
+    
+    case MPC_TYPE_DFA:
+      p->data.dfa.x = mpc_copy(a->data.dfa.x);
+      p->data.dfa.classes = malloc(256);
+      memcpy(p->data.dfa.classes, a->data.dfa.classes, 256);
+      p->data.dfa.accept = malloc(a->data.dfa.states);
+      memcpy(p->data.dfa.accept, a->data.dfa.accept, a->data.dfa.states);
+      p->data.dfa.trans = malloc(sizeof(short) * a->data.dfa.states * a->data.dfa.classes_num);
+      memcpy(p->data.dfa.trans, a->data.dfa.trans, sizeof(short) * a->data.dfa.states * a->data.dfa.classes_num);
+      break;
+    
+    case MPC_TYPE_JUMP:
+      p->data.jump.x = mpc_copy(a->data.jump.x);
+      p->data.jump.start = malloc(sizeof(int) * 256);
+      memcpy(p->data.jump.start, a->data.jump.start, sizeof(int) * 256);
+      break;
+    
     case MPC_TYPE_MAYBE:
     case MPC_TYPE_NOT:
       p->data.not.x = mpc_copy(a->data.not.x);
@@ -1727,6 +3122,17 @@ mpc_parser_t *mpc_predictive(mpc_parser_t *a) {
   return p;
 }
 
+mpc_parser_t *mpc_memo(mpc_parser_t *a, mpc_apply_t copy, mpc_dtor_t da) {
+  mpc_parser_t *p = mpc_undefined();
+  p->type = MPC_TYPE_MEMO;
+  p->data.memo.x = a;
+  p->data.memo.copy = copy;
+  p->data.memo.dx = da;
+  p->data.memo.lookups = 0;
+  p->data.memo.hits = 0;
+  return p;
+}
+
 mpc_parser_t *mpc_not_lift(mpc_parser_t *a, mpc_dtor_t da, mpc_ctor_t lf) {
   mpc_parser_t *p = mpc_undefined();
   p->type = MPC_TYPE_NOT;
@@ -2071,90 +3477,348 @@ static mpc_val_t *mpcf_re_escape(mpc_val_t *x) {
     return p;
   }
   
-  /* Regex Standard */
-  p = mpc_char(s[0]);
-  free(s);
-  return p;
+  /* Regex Standard */
+  p = mpc_char(s[0]);
+  free(s);
+  return p;
+}
+
+static const char *mpc_re_range_escape_char(char c) {
+  switch (c) {
+    case '-': return "-";
+    case 'a': return "\a";
+    case 'f': return "\f";
+    case 'n': return "\n";
+    case 'r': return "\r";
+    case 't': return "\t";
+    case 'v': return "\v";
+    case 'b': return "\b";
+    case 'd': return "0123456789";
+    case 's': return " \f\n\r\t\v";
+    case 'w': return "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+    default: return NULL;
+  }
+}
+
+static mpc_val_t *mpcf_re_range(mpc_val_t *x) {
+  
+  mpc_parser_t *out;
+  size_t i, j;
+  size_t start, end;
+  const char *tmp = NULL;
+  const char *s = x;
+  int comp = s[0] == '^' ? 1 : 0;
+  char *range = calloc(1,1);
+  
+  if (s[0] == '\0') { free(x); return mpc_fail("Invalid Regex Range Expression"); } 
+  if (s[0] == '^' && 
+      s[1] == '\0') { free(x); return mpc_fail("Invalid Regex Range Expression"); }
+  
+  for (i = comp; i < strlen(s); i++){
+    
+    /* Regex Range Escape */
+    if (s[i] == '\\') {
+      tmp = mpc_re_range_escape_char(s[i+1]);
+      if (tmp != NULL) {
+        range = realloc(range, strlen(range) + strlen(tmp) + 1);
+        strcat(range, tmp);
+      } else {
+        range = realloc(range, strlen(range) + 1 + 1);
+        range[strlen(range) + 1] = '\0';
+        range[strlen(range) + 0] = s[i+1];      
+      }
+      i++;
+    }
+    
+    /* Regex Range...Range */
+    else if (s[i] == '-') {
+      if (s[i+1] == '\0' || i == 0) {
+          range = realloc(range, strlen(range) + strlen("-") + 1);
+          strcat(range, "-");
+      } else {
+        start = s[i-1]+1;
+        end = s[i+1]-1;
+        for (j = start; j <= end; j++) {
+          range = realloc(range, strlen(range) + 1 + 1 + 1);
+          range[strlen(range) + 1] = '\0';
+          range[strlen(range) + 0] = (char)j;
+        }        
+      }
+    }
+    
+    /* Regex Range Normal */
+    else {
+      range = realloc(range, strlen(range) + 1 + 1);
+      range[strlen(range) + 1] = '\0';
+      range[strlen(range) + 0] = s[i];
+    }
+  
+  }
+  
+  out = comp == 1 ? mpc_noneof(range) : mpc_oneof(range);
+  
+  free(x);
+  free(range);
+  
+  return out;
+}
+
+/*
+** Where it is safe to do so the combinators built
+** for a regex are then compiled into a DFA, which
+** matches in a single pass using a transition table
+** indexed by character class.
+**
+** This is only safe when the two agree. The
+** combinators never backtrack into a choice or a
+** repeat which has succeeded, so we only compile
+** patterns where the next character always decides
+** which position of the pattern it matches (the
+** Glushkov automaton is deterministic). On top of
+** that only the last alternative of a choice may
+** match nothing, nothing which can match nothing
+** may be repeated, and anchors and lookahead are
+** not supported at all.
+**
+** The combinators are kept, and are used when the
+** DFA fails so that errors are unchanged.
+*/
+
+enum {
+  MPC_DFA_POS_MAX = 64
+};
+
+typedef struct {
+  int num;
+  char set[MPC_DFA_POS_MAX][256];
+  char follow[MPC_DFA_POS_MAX][MPC_DFA_POS_MAX];
+} mpc_dfa_build_t;
+
+typedef struct {
+  char nullable;
+  char first[MPC_DFA_POS_MAX];
+  char last[MPC_DFA_POS_MAX];
+} mpc_dfa_node_t;
+
+static void mpc_dfa_empty(mpc_dfa_node_t *n) {
+  memset(n, 0, sizeof(mpc_dfa_node_t));
+  n->nullable = 1;
+}
+
+static int mpc_parser_chars(mpc_parser_t *p, char *set) {
+  
+  int c;
+  char x;
+  
+  /* Ask the same questions as the mpc_input functions */
+  for (c = 0; c < 256; c++) {
+    x = (char)c;
+    switch (p->type) {
+      case MPC_TYPE_ANY:    set[c] = 1; break;
+      case MPC_TYPE_SINGLE: set[c] = x == p->data.single.x; break;
+      case MPC_TYPE_RANGE:  set[c] = x >= p->data.range.x && x <= p->data.range.y; break;
+      case MPC_TYPE_ONEOF:  set[c] = strchr(p->data.string.x, x) != 0; break;
+      case MPC_TYPE_NONEOF: set[c] = strchr(p->data.string.x, x) == 0; break;
+      default: return 0;
+    }
+  }
+  
+  return 1;
+}
+
+static int mpc_dfa_position(mpc_dfa_build_t *b, mpc_parser_t *p, mpc_dfa_node_t *n) {
+  
+  int k;
+  
+  if (b->num == MPC_DFA_POS_MAX) { return 0; }
+  k = b->num++;
+  
+  if (!mpc_parser_chars(p, b->set[k])) { return 0; }
+  
+  memset(n, 0, sizeof(mpc_dfa_node_t));
+  n->first[k] = 1;
+  n->last[k] = 1;
+  return 1;
+}
+
+static void mpc_dfa_follow(mpc_dfa_build_t *b, const char *from, const char *to) {
+  int j, k;
+  for (j = 0; j < b->num; j++) {
+    if (!from[j]) { continue; }
+    for (k = 0; k < b->num; k++) {
+      if (to[k]) { b->follow[j][k] = 1; }
+    }
+  }
+}
+
+static void mpc_dfa_seq(mpc_dfa_build_t *b, mpc_dfa_node_t *n, mpc_dfa_node_t *m) {
+  
+  int k;
+  
+  mpc_dfa_follow(b, n->last, m->first);
+  
+  for (k = 0; k < b->num; k++) {
+    if (n->nullable && m->first[k]) { n->first[k] = 1; }
+    if (!m->nullable) { n->last[k] = 0; }
+    if (m->last[k]) { n->last[k] = 1; }
+  }
+  
+  n->nullable = n->nullable && m->nullable;
+}
+
+static int mpc_dfa_build(mpc_dfa_build_t *b, mpc_parser_t *p, mpc_dfa_node_t *n, int rewound) {
+  
+  int j, k;
+  mpc_dfa_node_t m;
+  
+  switch (p->type) {
+    
+    case MPC_TYPE_ANY:
+    case MPC_TYPE_SINGLE:
+    case MPC_TYPE_RANGE:
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+      return mpc_dfa_position(b, p, n);
+    
+    case MPC_TYPE_EXPECT:
+      return mpc_dfa_build(b, p->data.expect.x, n, rewound);
+    
+    case MPC_TYPE_LIFT:
+      if (p->data.lift.lf != mpcf_ctor_str) { return 0; }
+      mpc_dfa_empty(n);
+      return 1;
+    
+    case MPC_TYPE_MAYBE:
+      if (p->data.not.lf != mpcf_ctor_str) { return 0; }
+      if (!mpc_dfa_build(b, p->data.not.x, n, 0) || n->nullable) { return 0; }
+      n->nullable = 1;
+      return 1;
+    
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+      if (p->data.repeat.f != mpcf_strfold) { return 0; }
+      if (!mpc_dfa_build(b, p->data.repeat.x, n, 0) || n->nullable) { return 0; }
+      mpc_dfa_follow(b, n->last, n->first);
+      n->nullable = p->type == MPC_TYPE_MANY;
+      return 1;
+    
+    /*
+    ** Count does not rewind when it fails part way,
+    ** so the input is only restored if it is inside
+    ** an `and`, which can't be done with a DFA.
+    */
+    case MPC_TYPE_COUNT:
+      if (p->data.repeat.f != mpcf_strfold || p->data.repeat.n < 1) { return 0; }
+      if (p->data.repeat.n > 1 && !rewound) { return 0; }
+      mpc_dfa_empty(n);
+      for (j = 0; j < p->data.repeat.n; j++) {
+        if (!mpc_dfa_build(b, p->data.repeat.x, &m, 0)) { return 0; }
+        mpc_dfa_seq(b, n, &m);
+      }
+      return 1;
+    
+    case MPC_TYPE_AND:
+      if (p->data.and.f != mpcf_strfold || p->data.and.n == 0) { return 0; }
+      mpc_dfa_empty(n);
+      for (j = 0; j < p->data.and.n; j++) {
+        if (!mpc_dfa_build(b, p->data.and.xs[j], &m, 1)) { return 0; }
+        mpc_dfa_seq(b, n, &m);
+      }
+      return 1;
+    
+    case MPC_TYPE_OR:
+      if (p->data.or.n == 0) { return 0; }
+      memset(n, 0, sizeof(mpc_dfa_node_t));
+      for (j = 0; j < p->data.or.n; j++) {
+        if (!mpc_dfa_build(b, p->data.or.xs[j], &m, 0)) { return 0; }
+        if (m.nullable && j != p->data.or.n-1) { return 0; }
+        for (k = 0; k < b->num; k++) {
+          if (m.first[k]) { n->first[k] = 1; }
+          if (m.last[k]) { n->last[k] = 1; }
+        }
+        n->nullable = m.nullable;
+      }
+      return 1;
+    
+    default: return 0;
+  }
+  
 }
 
-static const char *mpc_re_range_escape_char(char c) {
-  switch (c) {
-    case '-': return "-";
-    case 'a': return "\a";
-    case 'f': return "\f";
-    case 'n': return "\n";
-    case 'r': return "\r";
-    case 't': return "\t";
-    case 'v': return "\v";
-    case 'b': return "\b";
-    case 'd': return "0123456789";
-    case 's': return " \f\n\r\t\v";
-    case 'w': return "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
-    default: return NULL;
+static int mpc_dfa_deterministic(mpc_dfa_build_t *b, mpc_dfa_node_t *n) {
+  
+  int s, j, c;
+  char seen[256];
+  const char *next;
+  
+  for (s = 0; s <= b->num; s++) {
+    next = s == 0 ? n->first : b->follow[s-1];
+    memset(seen, 0, 256);
+    for (j = 0; j < b->num; j++) {
+      if (!next[j]) { continue; }
+      for (c = 0; c < 256; c++) {
+        if (seen[c] && b->set[j][c]) { return 0; }
+        seen[c] |= b->set[j][c];
+      }
+    }
   }
+  
+  return 1;
 }
 
-static mpc_val_t *mpcf_re_range(mpc_val_t *x) {
+static mpc_parser_t *mpc_re_dfa(mpc_parser_t *a) {
   
-  mpc_parser_t *out;
-  size_t i, j;
-  size_t start, end;
-  const char *tmp = NULL;
-  const char *s = x;
-  int comp = s[0] == '^' ? 1 : 0;
-  char *range = calloc(1,1);
+  int s, j, c, k;
+  int reps[256];
+  const char *next;
+  mpc_parser_t *p;
+  mpc_pdata_dfa_t *d;
+  mpc_dfa_node_t n;
+  mpc_dfa_build_t *b = calloc(1, sizeof(mpc_dfa_build_t));
   
-  if (s[0] == '\0') { free(x); return mpc_fail("Invalid Regex Range Expression"); } 
-  if (s[0] == '^' && 
-      s[1] == '\0') { free(x); return mpc_fail("Invalid Regex Range Expression"); }
+  if (!mpc_dfa_build(b, a, &n, 0) || !mpc_dfa_deterministic(b, &n)) {
+    free(b);
+    return a;
+  }
   
-  for (i = comp; i < strlen(s); i++){
-    
-    /* Regex Range Escape */
-    if (s[i] == '\\') {
-      tmp = mpc_re_range_escape_char(s[i+1]);
-      if (tmp != NULL) {
-        range = realloc(range, strlen(range) + strlen(tmp) + 1);
-        strcat(range, tmp);
-      } else {
-        range = realloc(range, strlen(range) + 1 + 1);
-        range[strlen(range) + 1] = '\0';
-        range[strlen(range) + 0] = s[i+1];      
+  p = mpc_undefined();
+  p->type = MPC_TYPE_DFA;
+  d = &p->data.dfa;
+  d->x = a;
+  d->states = b->num + 1;
+  d->classes = malloc(256);
+  d->classes_num = 0;
+  
+  /* Characters matched at exactly the same positions share a class */
+  for (c = 0; c < 256; c++) {
+    for (k = 0; k < d->classes_num; k++) {
+      for (j = 0; j < b->num; j++) {
+        if (b->set[j][c] != b->set[j][reps[k]]) { break; }
       }
-      i++;
+      if (j == b->num) { break; }
     }
-    
-    /* Regex Range...Range */
-    else if (s[i] == '-') {
-      if (s[i+1] == '\0' || i == 0) {
-          range = realloc(range, strlen(range) + strlen("-") + 1);
-          strcat(range, "-");
-      } else {
-        start = s[i-1]+1;
-        end = s[i+1]-1;
-        for (j = start; j <= end; j++) {
-          range = realloc(range, strlen(range) + 1 + 1 + 1);
-          range[strlen(range) + 1] = '\0';
-          range[strlen(range) + 0] = (char)j;
-        }        
+    if (k == d->classes_num) { reps[d->classes_num++] = c; }
+    d->classes[c] = (unsigned char)k;
+  }
+  
+  d->accept = malloc(d->states);
+  d->trans = malloc(sizeof(short) * d->states * d->classes_num);
+  
+  for (s = 0; s < d->states; s++) {
+    d->accept[s] = s == 0 ? n.nullable : n.last[s-1];
+    next = s == 0 ? n.first : b->follow[s-1];
+    for (k = 0; k < d->classes_num; k++) {
+      d->trans[s * d->classes_num + k] = -1;
+      for (j = 0; j < b->num; j++) {
+        if (next[j] && b->set[j][reps[k]]) {
+          d->trans[s * d->classes_num + k] = (short)(j + 1);
+        }
       }
     }
-    
-    /* Regex Range Normal */
-    else {
-      range = realloc(range, strlen(range) + 1 + 1);
-      range[strlen(range) + 1] = '\0';
-      range[strlen(range) + 0] = s[i];
-    }
-  
   }
   
-  out = comp == 1 ? mpc_noneof(range) : mpc_oneof(range);
-  
-  free(x);
-  free(range);
-  
-  return out;
+  free(b);
+  return p;
 }
 
 mpc_parser_t *mpc_re(const char *re) {
@@ -2220,7 +3884,7 @@ mpc_parser_t *mpc_re(const char *re) {
   
   mpc_optimise(r.output);
   
-  return r.output;
+  return mpc_re_dfa(r.output);
   
 }
 
@@ -2561,6 +4225,9 @@ static void mpc_print_unretained(mpc_parser_t *p, int force) {
   if (p->type == MPC_TYPE_APPLY)    { mpc_print_unretained(p->data.apply.x, 0); }
   if (p->type == MPC_TYPE_APPLY_TO) { mpc_print_unretained(p->data.apply_to.x, 0); }
   if (p->type == MPC_TYPE_PREDICT)  { mpc_print_unretained(p->data.predict.x, 0); }
+  if (p->type == MPC_TYPE_MEMO)     { mpc_print_unretained(p->data.memo.x, 0); }
+  if (p->type == MPC_TYPE_DFA)      { mpc_print_unretained(p->data.dfa.x, 0); }
+  if (p->type == MPC_TYPE_JUMP)     { mpc_print_unretained(p->data.jump.x, 0); }
 
   if (p->type == MPC_TYPE_NOT)   { mpc_print_unretained(p->data.not.x, 0); printf("!"); }
   if (p->type == MPC_TYPE_MAYBE) { mpc_print_unretained(p->data.not.x, 0); printf("?"); }
@@ -2690,24 +4357,53 @@ static void mpc_ast_delete_no_children(mpc_ast_t *a) {
   free(a);
 }
 
-mpc_ast_t *mpc_ast_new(const char *tag, const char *contents) {
+static mpc_ast_t *mpc_ast_new_len(const char *tag, const char *contents, long len) {
   
   mpc_ast_t *a = malloc(sizeof(mpc_ast_t));
   
   a->tag = malloc(strlen(tag) + 1);
   strcpy(a->tag, tag);
   
-  a->contents = malloc(strlen(contents) + 1);
-  strcpy(a->contents, contents);
+  a->contents = malloc(len + 1);
+  memcpy(a->contents, contents, len);
+  a->contents[len] = '\0';
+  a->contents_len = len;
   
   a->state = mpc_state_new();
   
   a->children_num = 0;
   a->children = NULL;
+  a->tagset = mpc_tagset(tag);
   return a;
   
 }
 
+mpc_ast_t *mpc_ast_new(const char *tag, const char *contents) {
+  return mpc_ast_new_len(tag, contents, (long)strlen(contents));
+}
+
+mpc_ast_t *mpc_ast_copy(mpc_ast_t *a) {
+  
+  int i;
+  mpc_ast_t *b;
+  
+  if (a == NULL) { return NULL; }
+  
+  b = mpc_ast_new_len(a->tag, a->contents, a->contents_len);
+  
+  b->state = a->state;
+  b->tagset = a->tagset;
+  b->children_num = a->children_num;
+  b->children = a->children_num
+    ? malloc(sizeof(mpc_ast_t*) * a->children_num) : NULL;
+  
+  for (i = 0; i < a->children_num; i++) {
+    b->children[i] = mpc_ast_copy(a->children[i]);
+  }
+  
+  return b;
+}
+
 mpc_ast_t *mpc_ast_build(int n, const char *tag, ...) {
   
   mpc_ast_t *a = mpc_ast_new(tag, "");
@@ -2744,7 +4440,8 @@ int mpc_ast_eq(mpc_ast_t *a, mpc_ast_t *b) {
   int i;
 
   if (strcmp(a->tag, b->tag) != 0) { return 0; }
-  if (strcmp(a->contents, b->contents) != 0) { return 0; }
+  if (a->contents_len != b->contents_len) { return 0; }
+  if (memcmp(a->contents, b->contents, a->contents_len) != 0) { return 0; }
   if (a->children_num != b->children_num) { return 0; }
   
   for (i = 0; i < a->children_num; i++) {
@@ -2767,20 +4464,27 @@ mpc_ast_t *mpc_ast_add_tag(mpc_ast_t *a, const char *t) {
   memmove(a->tag + strlen(t) + 1, a->tag, strlen(a->tag)+1);
   memmove(a->tag, t, strlen(t));
   memmove(a->tag + strlen(t), "|", 1);
+  a->tagset |= mpc_tagset(t);
   return a;
 }
 
-mpc_ast_t *mpc_ast_add_root_tag(mpc_ast_t *a, const char *t) {
-  if (a == NULL) { return a; }
+static mpc_ast_t *mpc_ast_add_root_tagset(mpc_ast_t *a, const char *t, unsigned long set) {
   a->tag = realloc(a->tag, (strlen(t)-1) + strlen(a->tag) + 1);
   memmove(a->tag + (strlen(t)-1), a->tag, strlen(a->tag)+1);
   memmove(a->tag, t, (strlen(t)-1));
+  a->tagset |= set;
   return a;
 }
 
+mpc_ast_t *mpc_ast_add_root_tag(mpc_ast_t *a, const char *t) {
+  if (a == NULL) { return a; }
+  return mpc_ast_add_root_tagset(a, t, mpc_tagset(t));
+}
+
 mpc_ast_t *mpc_ast_tag(mpc_ast_t *a, const char *t) {
   a->tag = realloc(a->tag, strlen(t) + 1);
   strcpy(a->tag, t);
+  a->tagset = mpc_tagset(t);
   return a;
 }
 
@@ -2801,11 +4505,11 @@ static void mpc_ast_print_depth(mpc_ast_t *a, int d, FILE *fp) {
   
   for (i = 0; i < d; i++) { fprintf(fp, "  "); }
   
-  if (strlen(a->contents)) {
-    fprintf(fp, "%s:%lu:%lu '%s'\n", a->tag, 
+  if (a->contents_len) {
+    fprintf(fp, "%s:%lu:%lu '%.*s'\n", a->tag, 
       (long unsigned int)(a->state.row+1),
       (long unsigned int)(a->state.col+1),
-      a->contents);
+      (int)a->contents_len, a->contents);
   } else {
     fprintf(fp, "%s \n", a->tag);
   }
@@ -3012,7 +4716,7 @@ mpc_val_t *mpcf_fold_ast(int n, mpc_val_t **xs) {
     if        (as[i] && as[i]->children_num == 0) {
       mpc_ast_add_child(r, as[i]);
     } else if (as[i] && as[i]->children_num == 1) {
-      mpc_ast_add_child(r, mpc_ast_add_root_tag(as[i]->children[0], as[i]->tag));
+      mpc_ast_add_child(r, mpc_ast_add_root_tagset(as[i]->children[0], as[i]->tag, as[i]->tagset));
       mpc_ast_delete_no_children(as[i]);
     } else if (as[i] && as[i]->children_num >= 2) {
       for (j = 0; j < as[i]->children_num; j++) {
@@ -3050,11 +4754,11 @@ mpc_parser_t *mpca_state(mpc_parser_t *a) {
 }
 
 mpc_parser_t *mpca_tag(mpc_parser_t *a, const char *t) {
-  return mpc_apply_to(a, (mpc_apply_to_t)mpc_ast_tag, (void*)t);
+  return mpc_apply_to(a, mpcf_tag_ast, mpc_tag_intern(t, strlen(t)));
 }
 
 mpc_parser_t *mpca_add_tag(mpc_parser_t *a, const char *t) {
-  return mpc_apply_to(a, (mpc_apply_to_t)mpc_ast_add_tag, (void*)t);
+  return mpc_apply_to(a, mpcf_add_tag_ast, mpc_tag_intern(t, strlen(t)));
 }
 
 mpc_parser_t *mpca_root(mpc_parser_t *a) {
@@ -3430,6 +5134,10 @@ static mpc_val_t *mpca_stmt_list_apply_to(mpc_val_t *x, void *s) {
     left = mpca_grammar_find_parser(stmt->ident, st);
     if (st->flags & MPCA_LANG_PREDICTIVE) { stmt->grammar = mpc_predictive(stmt->grammar); }
     if (stmt->name) { stmt->grammar = mpc_expect(stmt->grammar, stmt->name); }
+    if (st->flags & MPCA_LANG_PACKRAT) {
+      stmt->grammar = mpc_memo(stmt->grammar,
+        (mpc_apply_t)mpc_ast_copy, (mpc_dtor_t)mpc_ast_delete);
+    }
     mpc_optimise(stmt->grammar);
     mpc_define(left, stmt->grammar);
     free(stmt->ident);
@@ -3443,6 +5151,270 @@ static mpc_val_t *mpca_stmt_list_apply_to(mpc_val_t *x, void *s) {
   return NULL;
 }
 
+/*
+** Predictive Choice
+**
+** Once a grammar is defined the FIRST set of every
+** parser reachable from its rules is found, along
+** with whether it can succeed without consuming
+** any input. Each choice is then given a table from
+** the next character to the first alternative which
+** could possibly match, and the alternatives before
+** it are skipped instead of being tried and rewound.
+**
+** Skipped alternatives could only have added errors,
+** so as with the DFA the tables are only used over
+** String inputs, and a failed parse is run again
+** without them to build the very same message.
+*/
+
+typedef struct {
+  int num;
+  int slots;
+  mpc_parser_t **nodes;
+  char *nullable;
+  char (*first)[256];
+  int hash_slots;
+  int *hash;
+} mpc_ll_t;
+
+/*
+** A choice given a table by an earlier grammar is seen
+** through its jump straight to the alternatives, so that
+** the choice itself is never given a second table.
+*/
+
+static int mpc_ll_children(mpc_parser_t *p, mpc_parser_t ***xs) {
+  switch (p->type) {
+    case MPC_TYPE_EXPECT:   *xs = &p->data.expect.x;   return 1;
+    case MPC_TYPE_APPLY:    *xs = &p->data.apply.x;    return 1;
+    case MPC_TYPE_APPLY_TO: *xs = &p->data.apply_to.x; return 1;
+    case MPC_TYPE_PREDICT:  *xs = &p->data.predict.x;  return 1;
+    case MPC_TYPE_MEMO:     *xs = &p->data.memo.x;     return 1;
+    case MPC_TYPE_DFA:      *xs = &p->data.dfa.x;      return 1;
+    case MPC_TYPE_JUMP:     *xs = p->data.jump.x->data.or.xs; return p->data.jump.x->data.or.n;
+    case MPC_TYPE_NOT:
+    case MPC_TYPE_MAYBE:    *xs = &p->data.not.x;      return 1;
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+    case MPC_TYPE_COUNT:    *xs = &p->data.repeat.x;   return 1;
+    case MPC_TYPE_OR:       *xs = p->data.or.xs;       return p->data.or.n;
+    case MPC_TYPE_AND:      *xs = p->data.and.xs;      return p->data.and.n;
+    default: return 0;
+  }
+}
+
+static int *mpc_ll_slot(mpc_ll_t *l, mpc_parser_t *p) {
+  unsigned long h = (unsigned long)(size_t)p / sizeof(mpc_parser_t);
+  int k = (int)((h * 2654435761UL) & (unsigned long)(l->hash_slots - 1));
+  while (l->hash[k] && l->nodes[l->hash[k]-1] != p) {
+    k = (k + 1) & (l->hash_slots - 1);
+  }
+  return &l->hash[k];
+}
+
+static void mpc_ll_add(mpc_ll_t *l, mpc_parser_t *p) {
+  
+  int j;
+  int *slot = mpc_ll_slot(l, p);
+  if (*slot) { return; }
+  
+  if (l->num == l->slots) {
+    l->slots *= 2;
+    l->nodes = realloc(l->nodes, sizeof(mpc_parser_t*) * l->slots);
+    l->nullable = realloc(l->nullable, l->slots);
+    l->first = realloc(l->first, 256 * l->slots);
+  }
+  
+  l->nodes[l->num] = p;
+  l->nullable[l->num] = 0;
+  memset(l->first[l->num], 0, 256);
+  *slot = ++l->num;
+  
+  if (l->num * 2 > l->hash_slots) {
+    l->hash_slots *= 2;
+    l->hash = realloc(l->hash, sizeof(int) * l->hash_slots);
+    memset(l->hash, 0, sizeof(int) * l->hash_slots);
+    for (j = 0; j < l->num; j++) {
+      *mpc_ll_slot(l, l->nodes[j]) = j + 1;
+    }
+  }
+}
+
+static int mpc_ll_union(mpc_ll_t *l, char *first, mpc_parser_t *p) {
+  int c, j = *mpc_ll_slot(l, p) - 1;
+  for (c = 0; c < 256; c++) {
+    if (l->first[j][c]) { first[c] = 1; }
+  }
+  return l->nullable[j];
+}
+
+static int mpc_ll_update(mpc_ll_t *l, int j) {
+  
+  int c, k, n, changed = 0;
+  char first[256], nullable = 0;
+  mpc_parser_t *p = l->nodes[j], **xs;
+  
+  memset(first, 0, 256);
+  n = mpc_ll_children(p, &xs);
+  
+  switch (p->type) {
+    
+    case MPC_TYPE_ANY:
+    case MPC_TYPE_SINGLE:
+    case MPC_TYPE_RANGE:
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+      mpc_parser_chars(p, first);
+      break;
+    
+    case MPC_TYPE_STRING:
+      if (p->data.string.x[0]) {
+        first[(unsigned char)p->data.string.x[0]] = 1;
+      } else {
+        nullable = 1;
+      }
+      break;
+    
+    case MPC_TYPE_SATISFY:
+      memset(first, 1, 256);
+      break;
+    
+    case MPC_TYPE_FAIL:
+      break;
+    
+    case MPC_TYPE_PASS:
+    case MPC_TYPE_LIFT:
+    case MPC_TYPE_LIFT_VAL:
+    case MPC_TYPE_STATE:
+    case MPC_TYPE_ANCHOR:
+    case MPC_TYPE_NOT:
+      nullable = 1;
+      break;
+    
+    case MPC_TYPE_EXPECT:
+    case MPC_TYPE_APPLY:
+    case MPC_TYPE_APPLY_TO:
+    case MPC_TYPE_PREDICT:
+    case MPC_TYPE_MEMO:
+    case MPC_TYPE_DFA:
+    case MPC_TYPE_MANY1:
+      nullable = mpc_ll_union(l, first, xs[0]);
+      break;
+    
+    case MPC_TYPE_MAYBE:
+    case MPC_TYPE_MANY:
+      mpc_ll_union(l, first, xs[0]);
+      nullable = 1;
+      break;
+    
+    case MPC_TYPE_COUNT:
+      nullable = mpc_ll_union(l, first, xs[0]) || p->data.repeat.n < 1;
+      break;
+    
+    case MPC_TYPE_OR:
+    case MPC_TYPE_JUMP:
+      for (k = 0; k < n; k++) {
+        if (mpc_ll_union(l, first, xs[k])) { nullable = 1; }
+      }
+      if (n == 0) { nullable = 1; }
+      break;
+    
+    case MPC_TYPE_AND:
+      nullable = 1;
+      for (k = 0; k < n && nullable; k++) {
+        nullable = mpc_ll_union(l, first, xs[k]);
+      }
+      break;
+    
+    /* Rules which are not yet defined could be anything */
+    default:
+      memset(first, 1, 256);
+      nullable = 1;
+      break;
+  }
+  
+  for (c = 0; c < 256; c++) {
+    if (first[c] && !l->first[j][c]) { l->first[j][c] = 1; changed = 1; }
+  }
+  if (nullable && !l->nullable[j]) { l->nullable[j] = 1; changed = 1; }
+  
+  return changed;
+}
+
+static void mpc_ll_jump(mpc_ll_t *l, mpc_parser_t *p) {
+  
+  int c, j, k, n = p->data.or.n, skips = 0, conflicts = 0;
+  int *start = malloc(sizeof(int) * 256);
+  mpc_parser_t *x;
+  
+  /* Every further alternative which might match counts as a conflict */
+  for (c = 0; c < 256; c++) {
+    start[c] = n;
+    for (j = n-1; j >= 0; j--) {
+      k = *mpc_ll_slot(l, p->data.or.xs[j]) - 1;
+      if (l->nullable[k] || l->first[k][c]) {
+        if (start[c] != n) { conflicts++; }
+        start[c] = j;
+      }
+    }
+    if (start[c] > 0) { skips = 1; }
+  }
+  
+  if (!skips) { free(start); return; }
+  
+  x = malloc(sizeof(mpc_parser_t));
+  memcpy(x, p, sizeof(mpc_parser_t));
+  x->retained = 0;
+  x->name = NULL;
+  
+  p->type = MPC_TYPE_JUMP;
+  p->data.jump.x = x;
+  p->data.jump.start = start;
+  p->data.jump.conflicts = conflicts;
+}
+
+static void mpc_ll_optimise(mpc_parser_t **ps, int n) {
+  
+  int j, k, m, changed;
+  mpc_parser_t **xs;
+  mpc_ll_t l;
+  
+  l.num = 0;
+  l.slots = 32;
+  l.nodes = malloc(sizeof(mpc_parser_t*) * l.slots);
+  l.nullable = malloc(l.slots);
+  l.first = malloc(256 * l.slots);
+  l.hash_slots = 64;
+  l.hash = calloc(l.hash_slots, sizeof(int));
+  
+  for (j = 0; j < n; j++) { mpc_ll_add(&l, ps[j]); }
+  
+  for (j = 0; j < l.num; j++) {
+    m = mpc_ll_children(l.nodes[j], &xs);
+    for (k = 0; k < m; k++) { mpc_ll_add(&l, xs[k]); }
+  }
+  
+  /* Children come later in the list so go backwards */
+  do {
+    changed = 0;
+    for (j = l.num-1; j >= 0; j--) {
+      changed = mpc_ll_update(&l, j) || changed;
+    }
+  } while (changed);
+  
+  for (j = 0; j < l.num; j++) {
+    if (l.nodes[j]->type == MPC_TYPE_OR && l.nodes[j]->data.or.n > 1) {
+      mpc_ll_jump(&l, l.nodes[j]);
+    }
+  }
+  
+  free(l.nodes);
+  free(l.nullable);
+  free(l.first);
+  free(l.hash);
+}
+
 static mpc_err_t *mpca_lang_st(mpc_input_t *i, mpca_grammar_st_t *st) {
   
   mpc_result_t r;
@@ -3504,28 +5476,74 @@ static mpc_err_t *mpca_lang_st(mpc_input_t *i, mpca_grammar_st_t *st) {
   if (!mpc_parse_input(i, Lang, &r)) {
     e = r.error;
   } else {
+    mpc_ll_optimise(st->parsers, st->parsers_num);
     e = NULL;
   }
   
-  mpc_cleanup(6, Lang, Stmt, Grammar, Term, Factor, Base);
+  mpc_cleanup(6, Lang, Stmt, Grammar, Term, Factor, Base);
+  
+  return e;
+}
+
+mpc_err_t *mpca_lang_file(int flags, FILE *f, ...) {
+  mpca_grammar_st_t st;
+  mpc_input_t *i;
+  mpc_err_t *err;
+
+  va_list va;  
+  va_start(va, f);
+  
+  st.va = &va;
+  st.parsers_num = 0;
+  st.parsers = NULL;
+  st.flags = flags;
+  
+  i = mpc_input_new_file("<mpca_lang_file>", f);
+  err = mpca_lang_st(i, &st);
+  mpc_input_delete(i);
+  
+  free(st.parsers);
+  va_end(va);
+  return err;
+}
+
+mpc_err_t *mpca_lang_pipe(int flags, FILE *p, ...) {
+  mpca_grammar_st_t st;
+  mpc_input_t *i;
+  mpc_err_t *err;
+
+  va_list va;  
+  va_start(va, p);
+  
+  st.va = &va;
+  st.parsers_num = 0;
+  st.parsers = NULL;
+  st.flags = flags;
+  
+  i = mpc_input_new_pipe("<mpca_lang_pipe>", p);
+  err = mpca_lang_st(i, &st);
+  mpc_input_delete(i);
   
-  return e;
+  free(st.parsers);
+  va_end(va);
+  return err;
 }
 
-mpc_err_t *mpca_lang_file(int flags, FILE *f, ...) {
+mpc_err_t *mpca_lang(int flags, const char *language, ...) {
+  
   mpca_grammar_st_t st;
   mpc_input_t *i;
   mpc_err_t *err;
-
+  
   va_list va;  
-  va_start(va, f);
+  va_start(va, language);
   
   st.va = &va;
   st.parsers_num = 0;
   st.parsers = NULL;
   st.flags = flags;
   
-  i = mpc_input_new_file("<mpca_lang_file>", f);
+  i = mpc_input_new_string("<mpca_lang>", language);
   err = mpca_lang_st(i, &st);
   mpc_input_delete(i);
   
@@ -3534,35 +5552,560 @@ mpc_err_t *mpca_lang_file(int flags, FILE *f, ...) {
   return err;
 }
 
-mpc_err_t *mpca_lang_pipe(int flags, FILE *p, ...) {
+mpc_err_t *mpca_lang_contents(int flags, const char *filename, ...) {
+  
   mpca_grammar_st_t st;
   mpc_input_t *i;
   mpc_err_t *err;
+  
+  va_list va;
 
-  va_list va;  
-  va_start(va, p);
+  FILE *f = NULL;
+  
+  i = mpc_input_new_mmap(filename);
+  
+  if (i == NULL) {
+    
+    f = fopen(filename, "rb");
+    
+    if (f == NULL) {
+      err = mpc_err_file(filename, "Unable to open file!");
+      return err;
+    }
+    
+    i = mpc_input_new_file(filename, f);
+  }
+  
+  va_start(va, filename);
   
   st.va = &va;
   st.parsers_num = 0;
   st.parsers = NULL;
   st.flags = flags;
   
-  i = mpc_input_new_pipe("<mpca_lang_pipe>", p);
   err = mpca_lang_st(i, &st);
   mpc_input_delete(i);
   
   free(st.parsers);
-  va_end(va);
+  va_end(va);  
+  
+  if (f) { fclose(f); }
+  
   return err;
 }
 
-mpc_err_t *mpca_lang(int flags, const char *language, ...) {
+/*
+** Saved Grammars
+**
+** A grammar built from a language can be saved and
+** then loaded again without parsing the language or
+** optimising the parsers a second time.
+**
+** Each rule is written out as a tree of nodes, where
+** other rules are referred to by their position in
+** the argument list. Functions are written as their
+** position in the table below, so only grammars which
+** use functions mpc knows about can be saved, and the
+** version must change whenever the table does.
+**
+** Saved data also records a hash of the language and
+** flags it was built from. If the data does not match
+** them it is ignored and the language is parsed.
+*/
+
+typedef void (*mpc_save_fn_t)(void);
+
+static const mpc_save_fn_t mpc_save_fns[] = {
+  NULL,
+  (mpc_save_fn_t)free,
+  (mpc_save_fn_t)mpcf_dtor_null,
+  (mpc_save_fn_t)mpcf_ctor_null,
+  (mpc_save_fn_t)mpcf_ctor_str,
+  (mpc_save_fn_t)mpcf_free,
+  (mpc_save_fn_t)mpcf_int,
+  (mpc_save_fn_t)mpcf_hex,
+  (mpc_save_fn_t)mpcf_oct,
+  (mpc_save_fn_t)mpcf_float,
+  (mpc_save_fn_t)mpcf_strtriml,
+  (mpc_save_fn_t)mpcf_strtrimr,
+  (mpc_save_fn_t)mpcf_strtrim,
+  (mpc_save_fn_t)mpcf_escape,
+  (mpc_save_fn_t)mpcf_escape_regex,
+  (mpc_save_fn_t)mpcf_escape_string_raw,
+  (mpc_save_fn_t)mpcf_escape_char_raw,
+  (mpc_save_fn_t)mpcf_unescape,
+  (mpc_save_fn_t)mpcf_unescape_regex,
+  (mpc_save_fn_t)mpcf_unescape_string_raw,
+  (mpc_save_fn_t)mpcf_unescape_char_raw,
+  (mpc_save_fn_t)mpcf_null,
+  (mpc_save_fn_t)mpcf_fst,
+  (mpc_save_fn_t)mpcf_snd,
+  (mpc_save_fn_t)mpcf_trd,
+  (mpc_save_fn_t)mpcf_fst_free,
+  (mpc_save_fn_t)mpcf_snd_free,
+  (mpc_save_fn_t)mpcf_trd_free,
+  (mpc_save_fn_t)mpcf_strfold,
+  (mpc_save_fn_t)mpcf_maths,
+  (mpc_save_fn_t)mpcf_fold_ast,
+  (mpc_save_fn_t)mpcf_str_ast,
+  (mpc_save_fn_t)mpcf_state_ast,
+  (mpc_save_fn_t)mpcf_tag_ast,
+  (mpc_save_fn_t)mpcf_add_tag_ast,
+  (mpc_save_fn_t)mpc_ast_delete,
+  (mpc_save_fn_t)mpc_ast_copy,
+  (mpc_save_fn_t)mpc_ast_add_root,
+  (mpc_save_fn_t)mpc_soi_anchor,
+  (mpc_save_fn_t)mpc_eoi_anchor,
+  (mpc_save_fn_t)mpc_boundary_anchor
+};
+
+enum {
+  MPC_SAVE_VERSION = 1,
+  MPC_SAVE_FNS_NUM = sizeof(mpc_save_fns) / sizeof(mpc_save_fn_t),
+  MPC_SAVE_RULE = 0xFF
+};
+
+typedef struct {
+  FILE *f;
+  int error;
+  int parsers_num;
+  mpc_parser_t **parsers;
+} mpc_save_t;
+
+typedef struct {
+  const unsigned char *data;
+  long length;
+  long pos;
+  int error;
+  int parsers_num;
+  mpc_parser_t **parsers;
+} mpc_load_t;
+
+static unsigned long mpca_lang_hash(int flags, const char *language) {
+  unsigned long h = 5381 + MPC_SAVE_VERSION;
+  for (; *language; language++) {
+    h = (h * 33 + (unsigned char)*language) & 0xFFFFFFFFUL;
+  }
+  return (h * 33 + (unsigned long)flags) & 0xFFFFFFFFUL;
+}
+
+/* Numbers are written seven bits at a time, low bits first */
+static void mpc_save_num(mpc_save_t *s, unsigned long x) {
+  while (x >= 0x80) {
+    fputc((int)(x & 0x7F) | 0x80, s->f);
+    x >>= 7;
+  }
+  fputc((int)x, s->f);
+}
+
+static void mpc_save_str(mpc_save_t *s, const char *x, size_t n) {
+  mpc_save_num(s, n);
+  fwrite(x, 1, n, s->f);
+}
+
+static void mpc_save_fn(mpc_save_t *s, mpc_save_fn_t f) {
+  int j;
+  for (j = 0; j < MPC_SAVE_FNS_NUM; j++) {
+    if (mpc_save_fns[j] == f) { mpc_save_num(s, j); return; }
+  }
+  mpc_save_num(s, MPC_SAVE_FNS_NUM);
+  s->error = 1;
+}
+
+static void mpc_save_node(mpc_save_t *s, mpc_parser_t *p, int force) {
+  
+  int j;
+  mpc_tag_t *t;
+  
+  if (p->retained && !force) {
+    for (j = 0; j < s->parsers_num; j++) {
+      if (s->parsers[j] == p) {
+        fputc(MPC_SAVE_RULE, s->f);
+        mpc_save_num(s, j);
+        return;
+      }
+    }
+    fputc(MPC_TYPE_UNDEFINED, s->f);
+    s->error = 1;
+    return;
+  }
+  
+  fputc(p->type, s->f);
+  
+  switch (p->type) {
+    
+    case MPC_TYPE_FAIL: mpc_save_str(s, p->data.fail.m, strlen(p->data.fail.m)); break;
+    case MPC_TYPE_LIFT: mpc_save_fn(s, (mpc_save_fn_t)p->data.lift.lf); break;
+    case MPC_TYPE_LIFT_VAL: if (p->data.lift.x) { s->error = 1; } break;
+    
+    case MPC_TYPE_EXPECT:
+      mpc_save_str(s, p->data.expect.m, strlen(p->data.expect.m));
+      mpc_save_node(s, p->data.expect.x, 0);
+      break;
+    
+    case MPC_TYPE_ANCHOR:  mpc_save_fn(s, (mpc_save_fn_t)p->data.anchor.f); break;
+    case MPC_TYPE_SATISFY: mpc_save_fn(s, (mpc_save_fn_t)p->data.satisfy.f); break;
+    case MPC_TYPE_SINGLE:  fputc((unsigned char)p->data.single.x, s->f); break;
+    
+    case MPC_TYPE_RANGE:
+      fputc((unsigned char)p->data.range.x, s->f);
+      fputc((unsigned char)p->data.range.y, s->f);
+      break;
+    
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+    case MPC_TYPE_STRING:
+      mpc_save_str(s, p->data.string.x, strlen(p->data.string.x));
+      break;
+    
+    case MPC_TYPE_APPLY:
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.apply.f);
+      mpc_save_node(s, p->data.apply.x, 0);
+      break;
+    
+    /* The only data known to mpc is an interned tag */
+    case MPC_TYPE_APPLY_TO:
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.apply_to.f);
+      if (p->data.apply_to.f == mpcf_tag_ast || p->data.apply_to.f == mpcf_add_tag_ast) {
+        t = p->data.apply_to.d;
+        mpc_save_str(s, t->name, t->len);
+      } else if (p->data.apply_to.d) {
+        s->error = 1;
+      }
+      mpc_save_node(s, p->data.apply_to.x, 0);
+      break;
+    
+    case MPC_TYPE_PREDICT: mpc_save_node(s, p->data.predict.x, 0); break;
+    
+    case MPC_TYPE_MEMO:
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.memo.copy);
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.memo.dx);
+      mpc_save_node(s, p->data.memo.x, 0);
+      break;
+    
+    case MPC_TYPE_DFA:
+      mpc_save_num(s, p->data.dfa.states);
+      mpc_save_num(s, p->data.dfa.classes_num);
+      fwrite(p->data.dfa.classes, 1, 256, s->f);
+      fwrite(p->data.dfa.accept, 1, p->data.dfa.states, s->f);
+      for (j = 0; j < p->data.dfa.states * p->data.dfa.classes_num; j++) {
+        mpc_save_num(s, p->data.dfa.trans[j] + 1);
+      }
+      mpc_save_node(s, p->data.dfa.x, 0);
+      break;
+    
+    case MPC_TYPE_JUMP:
+      mpc_save_num(s, p->data.jump.conflicts);
+      for (j = 0; j < 256; j++) { mpc_save_num(s, p->data.jump.start[j]); }
+      mpc_save_node(s, p->data.jump.x, 0);
+      break;
+    
+    case MPC_TYPE_NOT:
+    case MPC_TYPE_MAYBE:
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.not.dx);
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.not.lf);
+      mpc_save_node(s, p->data.not.x, 0);
+      break;
+    
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+    case MPC_TYPE_COUNT:
+      mpc_save_num(s, p->data.repeat.n);
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.repeat.f);
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.repeat.dx);
+      mpc_save_node(s, p->data.repeat.x, 0);
+      break;
+    
+    case MPC_TYPE_OR:
+      mpc_save_num(s, p->data.or.n);
+      for (j = 0; j < p->data.or.n; j++) { mpc_save_node(s, p->data.or.xs[j], 0); }
+      break;
+    
+    case MPC_TYPE_AND:
+      mpc_save_num(s, p->data.and.n);
+      mpc_save_fn(s, (mpc_save_fn_t)p->data.and.f);
+      for (j = 0; j < p->data.and.n-1; j++) { mpc_save_fn(s, (mpc_save_fn_t)p->data.and.dxs[j]); }
+      for (j = 0; j < p->data.and.n; j++) { mpc_save_node(s, p->data.and.xs[j], 0); }
+      break;
+    
+    default: break;
+  }
+  
+}
+
+static mpc_err_t *mpca_lang_save_st(FILE *f, int flags, const char *language, mpca_grammar_st_t *st) {
+  
+  int j;
+  mpc_save_t s;
+  
+  s.f = f;
+  s.error = 0;
+  s.parsers_num = st->parsers_num;
+  s.parsers = st->parsers;
+  
+  fputs("mpc", f);
+  fputc(MPC_SAVE_VERSION, f);
+  mpc_save_num(&s, mpca_lang_hash(flags, language));
+  mpc_save_num(&s, st->parsers_num);
+  for (j = 0; j < st->parsers_num; j++) {
+    mpc_save_node(&s, st->parsers[j], 1);
+  }
+  
+  if (s.error) { return mpc_err_file("<mpca_lang_save>", "Grammar uses a function which cannot be saved!"); }
+  if (ferror(f)) { return mpc_err_file("<mpca_lang_save>", "Unable to write file!"); }
+  return NULL;
+}
+
+static int mpc_load_byte(mpc_load_t *l) {
+  if (l->pos >= l->length) { l->error = 1; return 0; }
+  return l->data[l->pos++];
+}
+
+static unsigned long mpc_load_num(mpc_load_t *l) {
+  
+  unsigned long x = 0;
+  int c, shift = 0;
+  
+  do {
+    if (shift > 28) { l->error = 1; return 0; }
+    c = mpc_load_byte(l);
+    x |= (unsigned long)(c & 0x7F) << shift;
+    shift += 7;
+  } while (c & 0x80);
+  
+  return x;
+}
+
+/* Counts are checked against the data left, so bad data cannot ask for huge allocations */
+static int mpc_load_count(mpc_load_t *l, unsigned long size) {
+  unsigned long n = mpc_load_num(l);
+  if (n > (unsigned long)(l->length - l->pos) / size) { l->error = 1; return 0; }
+  return (int)n;
+}
+
+static char *mpc_load_str(mpc_load_t *l) {
+  int n = mpc_load_count(l, 1);
+  char *x = malloc(n + 1);
+  memcpy(x, l->data + l->pos, n);
+  x[n] = '\0';
+  l->pos += n;
+  return x;
+}
+
+static mpc_save_fn_t mpc_load_fn(mpc_load_t *l) {
+  unsigned long j = mpc_load_num(l);
+  if (j >= MPC_SAVE_FNS_NUM) { l->error = 1; return NULL; }
+  return mpc_save_fns[j];
+}
+
+/*
+** Nodes are given their type before their data is
+** read, so a node which is only partly loaded can be
+** deleted as usual when the data turns out to be bad.
+*/
+
+static mpc_parser_t *mpc_load_node(mpc_load_t *l) {
+  
+  int j, type;
+  unsigned long x;
+  char *t;
+  mpc_parser_t *p;
+  
+  if (l->error) { return NULL; }
+  
+  type = mpc_load_byte(l);
+  
+  if (type == MPC_SAVE_RULE) {
+    x = mpc_load_num(l);
+    if (x >= (unsigned long)l->parsers_num) { l->error = 1; return NULL; }
+    return l->parsers[x];
+  }
+  
+  if (type > MPC_TYPE_JUMP) { l->error = 1; return NULL; }
+  
+  p = mpc_undefined();
+  p->type = type;
+  
+  switch (type) {
+    
+    case MPC_TYPE_FAIL: p->data.fail.m = mpc_load_str(l); break;
+    case MPC_TYPE_LIFT: p->data.lift.lf = (mpc_ctor_t)mpc_load_fn(l); break;
+    
+    case MPC_TYPE_EXPECT:
+      p->data.expect.m = mpc_load_str(l);
+      p->data.expect.x = mpc_load_node(l);
+      break;
+    
+    case MPC_TYPE_ANCHOR:  p->data.anchor.f = (int(*)(char,char))mpc_load_fn(l); break;
+    case MPC_TYPE_SATISFY: p->data.satisfy.f = (int(*)(char))mpc_load_fn(l); break;
+    case MPC_TYPE_SINGLE:  p->data.single.x = (char)mpc_load_byte(l); break;
+    
+    case MPC_TYPE_RANGE:
+      p->data.range.x = (char)mpc_load_byte(l);
+      p->data.range.y = (char)mpc_load_byte(l);
+      break;
+    
+    case MPC_TYPE_ONEOF:
+    case MPC_TYPE_NONEOF:
+    case MPC_TYPE_STRING:
+      p->data.string.x = mpc_load_str(l);
+      break;
+    
+    case MPC_TYPE_APPLY:
+      p->data.apply.f = (mpc_apply_t)mpc_load_fn(l);
+      p->data.apply.x = mpc_load_node(l);
+      break;
+    
+    case MPC_TYPE_APPLY_TO:
+      p->data.apply_to.f = (mpc_apply_to_t)mpc_load_fn(l);
+      if (p->data.apply_to.f == mpcf_tag_ast || p->data.apply_to.f == mpcf_add_tag_ast) {
+        t = mpc_load_str(l);
+        p->data.apply_to.d = mpc_tag_intern(t, strlen(t));
+        free(t);
+      }
+      p->data.apply_to.x = mpc_load_node(l);
+      break;
+    
+    case MPC_TYPE_PREDICT: p->data.predict.x = mpc_load_node(l); break;
+    
+    case MPC_TYPE_MEMO:
+      p->data.memo.copy = (mpc_apply_t)mpc_load_fn(l);
+      p->data.memo.dx = (mpc_dtor_t)mpc_load_fn(l);
+      p->data.memo.x = mpc_load_node(l);
+      break;
+    
+    case MPC_TYPE_DFA:
+      p->data.dfa.states = mpc_load_count(l, 1);
+      x = mpc_load_num(l);
+      if (p->data.dfa.states < 1 || p->data.dfa.states > 0x7FFF || x < 1 || x > 256
+      ||  l->length - l->pos < 256 + (long)p->data.dfa.states * (long)(x + 1)) {
+        l->error = 1;
+        break;
+      }
+      p->data.dfa.classes_num = (int)x;
+      p->data.dfa.classes = malloc(256);
+      p->data.dfa.accept = malloc(p->data.dfa.states);
+      p->data.dfa.trans = malloc(sizeof(short) * p->data.dfa.states * p->data.dfa.classes_num);
+      for (j = 0; j < 256; j++) {
+        p->data.dfa.classes[j] = (unsigned char)mpc_load_byte(l);
+        if (p->data.dfa.classes[j] >= p->data.dfa.classes_num) { l->error = 1; }
+      }
+      for (j = 0; j < p->data.dfa.states; j++) {
+        p->data.dfa.accept[j] = (char)mpc_load_byte(l);
+      }
+      for (j = 0; j < p->data.dfa.states * p->data.dfa.classes_num; j++) {
+        x = mpc_load_num(l);
+        if (x > (unsigned long)p->data.dfa.states) { l->error = 1; }
+        p->data.dfa.trans[j] = (short)((long)x - 1);
+      }
+      p->data.dfa.x = mpc_load_node(l);
+      break;
+    
+    /* The start table must only point at alternatives of the choice it jumps into */
+    case MPC_TYPE_JUMP:
+      p->data.jump.conflicts = (int)mpc_load_num(l);
+      p->data.jump.start = malloc(sizeof(int) * 256);
+      for (j = 0; j < 256; j++) { p->data.jump.start[j] = mpc_load_count(l, 1); }
+      p->data.jump.x = mpc_load_node(l);
+      if (l->error || p->data.jump.x->type != MPC_TYPE_OR || p->data.jump.x->retained) {
+        l->error = 1;
+        break;
+      }
+      for (j = 0; j < 256; j++) {
+        if (p->data.jump.start[j] > p->data.jump.x->data.or.n) { l->error = 1; }
+      }
+      break;
+    
+    case MPC_TYPE_NOT:
+    case MPC_TYPE_MAYBE:
+      p->data.not.dx = (mpc_dtor_t)mpc_load_fn(l);
+      p->data.not.lf = (mpc_ctor_t)mpc_load_fn(l);
+      p->data.not.x = mpc_load_node(l);
+      break;
+    
+    case MPC_TYPE_MANY:
+    case MPC_TYPE_MANY1:
+    case MPC_TYPE_COUNT:
+      p->data.repeat.n = (int)(mpc_load_num(l) & 0x7FFFFFFF);
+      p->data.repeat.f = (mpc_fold_t)mpc_load_fn(l);
+      p->data.repeat.dx = (mpc_dtor_t)mpc_load_fn(l);
+      p->data.repeat.x = mpc_load_node(l);
+      break;
+    
+    case MPC_TYPE_OR:
+      j = mpc_load_count(l, 1);
+      p->data.or.xs = calloc(j ? j : 1, sizeof(mpc_parser_t*));
+      p->data.or.n = j;
+      for (j = 0; j < p->data.or.n; j++) { p->data.or.xs[j] = mpc_load_node(l); }
+      break;
+    
+    case MPC_TYPE_AND:
+      j = mpc_load_count(l, 1);
+      p->data.and.xs = calloc(j ? j : 1, sizeof(mpc_parser_t*));
+      p->data.and.dxs = calloc(j ? j : 1, sizeof(mpc_dtor_t));
+      p->data.and.n = j;
+      p->data.and.f = (mpc_fold_t)mpc_load_fn(l);
+      for (j = 0; j < p->data.and.n-1; j++) { p->data.and.dxs[j] = (mpc_dtor_t)mpc_load_fn(l); }
+      for (j = 0; j < p->data.and.n; j++) { p->data.and.xs[j] = mpc_load_node(l); }
+      break;
+    
+    default: break;
+  }
+  
+  return p;
+}
+
+static int mpca_lang_load_st(const char *data, long length, int flags, const char *language, va_list *va) {
+  
+  int j;
+  mpc_load_t l;
+  mpc_parser_t **defs;
+  
+  l.data = (const unsigned char*)data;
+  l.length = length;
+  l.pos = 4;
+  l.error = 0;
+  
+  if (length < 4 || memcmp(data, "mpc", 3) != 0 || data[3] != MPC_SAVE_VERSION) { return 0; }
+  if (mpc_load_num(&l) != mpca_lang_hash(flags, language)) { return 0; }
+  l.parsers_num = mpc_load_count(&l, 1);
+  if (l.error) { return 0; }
+  
+  l.parsers = malloc(sizeof(mpc_parser_t*) * l.parsers_num);
+  for (j = 0; j < l.parsers_num; j++) {
+    l.parsers[j] = va_arg(*va, mpc_parser_t*);
+    if (l.parsers[j] == NULL) { free(l.parsers); return 0; }
+  }
+  
+  defs = calloc(l.parsers_num ? l.parsers_num : 1, sizeof(mpc_parser_t*));
+  for (j = 0; j < l.parsers_num; j++) {
+    defs[j] = mpc_load_node(&l);
+    if (defs[j] && defs[j]->retained) { defs[j] = NULL; l.error = 1; }
+  }
+  
+  if (l.error || l.pos != l.length) {
+    for (j = 0; j < l.parsers_num; j++) {
+      if (defs[j]) { mpc_undefine_unretained(defs[j], 0); }
+    }
+  } else {
+    for (j = 0; j < l.parsers_num; j++) {
+      mpc_define(l.parsers[j], defs[j]);
+    }
+  }
+  
+  j = !l.error && l.pos == l.length;
+  free(l.parsers);
+  free(defs);
+  return j;
+}
+
+mpc_err_t *mpca_lang_save(FILE *f, int flags, const char *language, ...) {
   
   mpca_grammar_st_t st;
   mpc_input_t *i;
   mpc_err_t *err;
   
-  va_list va;  
+  va_list va;
   va_start(va, language);
   
   st.va = &va;
@@ -3574,42 +6117,42 @@ mpc_err_t *mpca_lang(int flags, const char *language, ...) {
   err = mpca_lang_st(i, &st);
   mpc_input_delete(i);
   
+  if (err == NULL) { err = mpca_lang_save_st(f, flags, language, &st); }
+  
   free(st.parsers);
   va_end(va);
   return err;
 }
 
-mpc_err_t *mpca_lang_contents(int flags, const char *filename, ...) {
+mpc_err_t *mpca_lang_load(const char *data, long length, int flags, const char *language, ...) {
   
   mpca_grammar_st_t st;
   mpc_input_t *i;
   mpc_err_t *err;
   
   va_list va;
-
-  FILE *f = fopen(filename, "rb");
+  va_start(va, language);
   
-  if (f == NULL) {
-    err = mpc_err_file(filename, "Unable to open file!");
-    return err;
+  if (data && mpca_lang_load_st(data, length, flags, language, &va)) {
+    va_end(va);
+    return NULL;
   }
   
-  va_start(va, filename);
+  /* Start over with the arguments and build the grammar as usual */
+  va_end(va);
+  va_start(va, language);
   
   st.va = &va;
   st.parsers_num = 0;
   st.parsers = NULL;
   st.flags = flags;
   
-  i = mpc_input_new_file(filename, f);
+  i = mpc_input_new_string("<mpca_lang>", language);
   err = mpca_lang_st(i, &st);
   mpc_input_delete(i);
   
   free(st.parsers);
-  va_end(va);  
-  
-  fclose(f);
-  
+  va_end(va);
   return err;
 }
 
@@ -3624,6 +6167,9 @@ static int mpc_nodecount_unretained(mpc_parser_t* p, int force) {
   if (p->type == MPC_TYPE_APPLY)    { return 1 + mpc_nodecount_unretained(p->data.apply.x, 0); }
   if (p->type == MPC_TYPE_APPLY_TO) { return 1 + mpc_nodecount_unretained(p->data.apply_to.x, 0); }
   if (p->type == MPC_TYPE_PREDICT)  { return 1 + mpc_nodecount_unretained(p->data.predict.x, 0); }
+  if (p->type == MPC_TYPE_MEMO)     { return 1 + mpc_nodecount_unretained(p->data.memo.x, 0); }
+  if (p->type == MPC_TYPE_DFA)      { return 1 + mpc_nodecount_unretained(p->data.dfa.x, 0); }
+  if (p->type == MPC_TYPE_JUMP)     { return 1 + mpc_nodecount_unretained(p->data.jump.x, 0); }
 
   if (p->type == MPC_TYPE_NOT)   { return 1 + mpc_nodecount_unretained(p->data.not.x, 0); }
   if (p->type == MPC_TYPE_MAYBE) { return 1 + mpc_nodecount_unretained(p->data.not.x, 0); }
@@ -3652,10 +6198,35 @@ static int mpc_nodecount_unretained(mpc_parser_t* p, int force) {
   
 }
 
+static int mpc_conflicts_unretained(mpc_parser_t* p, int force) {
+  
+  int j, n, total = 0;
+  mpc_parser_t **xs;
+  
+  if (p->retained && !force) { return 0; }
+  
+  if (p->type == MPC_TYPE_JUMP) { total += p->data.jump.conflicts; }
+  
+  n = mpc_ll_children(p, &xs);
+  for (j = 0; j < n; j++) {
+    total += mpc_conflicts_unretained(xs[j], 0);
+  }
+  
+  return total;
+}
+
 void mpc_stats(mpc_parser_t* p) {
   printf("Stats\n");
   printf("=====\n");
   printf("Node Count: %i\n", mpc_nodecount_unretained(p, 1));
+  if (p->type == MPC_TYPE_MEMO) {
+    printf("Memo Lookups: %li\n", p->data.memo.lookups);
+    printf("Memo Hits: %li (%.1f%%)\n", p->data.memo.hits,
+      p->data.memo.lookups ? 100.0 * p->data.memo.hits / p->data.memo.lookups : 0.0);
+  }
+  printf("LL(1) Conflicts: %i\n", mpc_conflicts_unretained(p, 1));
+  printf("Pool Hits: %li (%.1f%%)\n", mpc_pool_hits,
+    mpc_pool_hits + mpc_pool_misses ? 100.0 * mpc_pool_hits / (mpc_pool_hits + mpc_pool_misses) : 0.0);
 }
 
 static void mpc_optimise_unretained(mpc_parser_t *p, int force) {
@@ -3671,6 +6242,8 @@ static void mpc_optimise_unretained(mpc_parser_t *p, int force) {
   if (p->type == MPC_TYPE_APPLY)    { mpc_optimise_unretained(p->data.apply.x, 0); }
   if (p->type == MPC_TYPE_APPLY_TO) { mpc_optimise_unretained(p->data.apply_to.x, 0); }
   if (p->type == MPC_TYPE_PREDICT)  { mpc_optimise_unretained(p->data.predict.x, 0); }
+  if (p->type == MPC_TYPE_MEMO)     { mpc_optimise_unretained(p->data.memo.x, 0); }
+  if (p->type == MPC_TYPE_DFA)      { mpc_optimise_unretained(p->data.dfa.x, 0); }
   if (p->type == MPC_TYPE_NOT)      { mpc_optimise_unretained(p->data.not.x, 0); }
   if (p->type == MPC_TYPE_MAYBE)    { mpc_optimise_unretained(p->data.not.x, 0); }
   if (p->type == MPC_TYPE_MANY)     { mpc_optimise_unretained(p->data.repeat.x, 0); }
@@ -3714,7 +6287,7 @@ static void mpc_optimise_unretained(mpc_parser_t *p, int force) {
       n = p->data.or.n; m = t->data.or.n;
       p->data.or.n = n + m - 1;
       p->data.or.xs = realloc(p->data.or.xs, sizeof(mpc_parser_t*) * (n + m -1));
-      memmove(p->data.or.xs + m, t->data.or.xs + 1, n * sizeof(mpc_parser_t*));
+      memmove(p->data.or.xs + m, p->data.or.xs + 1, (n - 1) * sizeof(mpc_parser_t*));
       memmove(p->data.or.xs, t->data.or.xs, m * sizeof(mpc_parser_t*));
       free(t->data.or.xs); free(t->name); free(t);
       continue;
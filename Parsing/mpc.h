@@ -123,6 +123,15 @@ mpc_parser_t *mpc_state(void);
 
 mpc_parser_t *mpc_expect(mpc_parser_t *a, const char *e);
 mpc_parser_t *mpc_expectf(mpc_parser_t *a, const char *fmt, ...);
+
+/*
+** When a parse of a string fails it is run a second time
+** to build the error, so the functions given to mpc_apply,
+** mpc_apply_to and the folds may be called twice for the
+** same input. They should have no side effects beyond the
+** value they return, which is freed as usual.
+*/
+
 mpc_parser_t *mpc_apply(mpc_parser_t *a, mpc_apply_t f);
 mpc_parser_t *mpc_apply_to(mpc_parser_t *a, mpc_apply_to_t f, void *x);
 
@@ -139,6 +148,7 @@ mpc_parser_t *mpc_or(int n, ...);
 mpc_parser_t *mpc_and(int n, mpc_fold_t f, ...);
 
 mpc_parser_t *mpc_predictive(mpc_parser_t *a);
+mpc_parser_t *mpc_memo(mpc_parser_t *a, mpc_apply_t copy, mpc_dtor_t da);
 
 /*
 ** Common Parsers
@@ -267,9 +277,12 @@ typedef struct mpc_ast_t {
   mpc_state_t state;
   int children_num;
   struct mpc_ast_t** children;
+  unsigned long tagset;
+  long contents_len;
 } mpc_ast_t;
 
 mpc_ast_t *mpc_ast_new(const char *tag, const char *contents);
+mpc_ast_t *mpc_ast_copy(mpc_ast_t *a);
 mpc_ast_t *mpc_ast_build(int n, const char *tag, ...);
 mpc_ast_t *mpc_ast_add_root(mpc_ast_t *a);
 mpc_ast_t *mpc_ast_add_child(mpc_ast_t *r, mpc_ast_t *a);
@@ -311,6 +324,54 @@ void mpc_ast_traverse_free(mpc_ast_trav_t **trav);
 */
 int mpc_ast_eq(mpc_ast_t *a, mpc_ast_t *b);
 
+/*
+** Tag names are interned to small ids, and the tag
+** functions above keep a set of the ids in each tag,
+** so checking for a name does not search the string.
+*/
+
+int mpc_tag_id(const char *name);
+int mpc_ast_has_tag(mpc_ast_t *a, int id);
+
+/*
+** Trees parsed into an arena are built from a few
+** large blocks and are released all at once by
+** clearing or deleting the arena. They must not be
+** passed to mpc_ast_delete or modified in place.
+**
+** An arena made with mpc_ast_arena_new_views also
+** keeps the text of each string it parses. Tokens
+** are matched without building their text at all,
+** and their contents point into the kept text. Such
+** contents are only contents_len bytes long and are
+** not terminated.
+*/
+
+typedef struct mpc_ast_arena_t mpc_ast_arena_t;
+
+mpc_ast_arena_t *mpc_ast_arena_new(void);
+mpc_ast_arena_t *mpc_ast_arena_new_views(void);
+void mpc_ast_arena_clear(mpc_ast_arena_t *a);
+void mpc_ast_arena_delete(mpc_ast_arena_t *a);
+
+int mpc_parse_arena(const char *filename, const char *string, mpc_parser_t *p, mpc_result_t *r, mpc_ast_arena_t *a);
+int mpc_parse_contents_arena(const char *filename, mpc_parser_t *p, mpc_result_t *r, mpc_ast_arena_t *a);
+
+/*
+** A context parses many strings one after another
+** without setting up a new input for each of them.
+** The string is only read during the call and is not
+** copied, except into a views arena.
+*/
+
+typedef struct mpc_context_t mpc_context_t;
+
+mpc_context_t *mpc_context_new(const char *filename);
+void mpc_context_delete(mpc_context_t *c);
+
+int mpc_parse_context(mpc_context_t *c, const char *string, mpc_parser_t *p, mpc_result_t *r);
+int mpc_parse_context_arena(mpc_context_t *c, const char *string, mpc_parser_t *p, mpc_result_t *r, mpc_ast_arena_t *a);
+
 mpc_val_t *mpcf_fold_ast(int n, mpc_val_t **as);
 mpc_val_t *mpcf_str_ast(mpc_val_t *c);
 mpc_val_t *mpcf_state_ast(int n, mpc_val_t **xs);
@@ -334,7 +395,8 @@ mpc_parser_t *mpca_and(int n, ...);
 enum {
   MPCA_LANG_DEFAULT              = 0,
   MPCA_LANG_PREDICTIVE           = 1,
-  MPCA_LANG_WHITESPACE_SENSITIVE = 2
+  MPCA_LANG_WHITESPACE_SENSITIVE = 2,
+  MPCA_LANG_PACKRAT              = 4
 };
 
 mpc_parser_t *mpca_grammar(int flags, const char *grammar, ...);
@@ -344,6 +406,17 @@ mpc_err_t *mpca_lang_file(int flags, FILE *f, ...);
 mpc_err_t *mpca_lang_pipe(int flags, FILE *f, ...);
 mpc_err_t *mpca_lang_contents(int flags, const char *filename, ...);
 
+/*
+** A grammar can be saved once it is built, and then
+** loaded from the saved data instead of parsing the
+** language again. Loading is given the same language,
+** flags and parsers, and parses the language as usual
+** if the data was saved from something else.
+*/
+
+mpc_err_t *mpca_lang_save(FILE *f, int flags, const char *language, ...);
+mpc_err_t *mpca_lang_load(const char *data, long length, int flags, const char *language, ...);
+
 /*
 ** Misc
 */
@@ -353,6 +426,16 @@ void mpc_print(mpc_parser_t *p);
 void mpc_optimise(mpc_parser_t *p);
 void mpc_stats(mpc_parser_t *p);
 
+/*
+** Each parse takes its small allocations from a pool
+** with room for the given number of blocks in each
+** size class. The counts say how many allocations the
+** pools served and how many went to malloc instead.
+*/
+
+void mpc_pool_capacity(long slots);
+void mpc_pool_stats(long *hits, long *misses);
+
 int mpc_test_pass(mpc_parser_t *p, const char *s, const void *d,
   int(*tester)(const void*, const void*), 
   mpc_dtor_t destructor, 
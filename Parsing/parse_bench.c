@@ -0,0 +1,99 @@
+#include "mpc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+// Times mpc over inputs from 1 KB to 100 MB, so that a change to mpc which
+// makes parsing worse than linear shows up as falling MB/s. Sizes in bytes
+// may be given as arguments instead.
+//
+// The parser is lispy's grammar written with combinators, and every match
+// is freed as soon as it is made. A tree of 100 MB of lispy takes over
+// 10 GB, so keeping it would time the allocator and the swap rather than
+// the parse.
+//
+//     cc -std=c99 -Wall -O2 parse_bench.c mpc.c -o parse_bench
+*/
+
+static const char* form = "(+ 1 (* 23 4)) ";
+
+static mpc_val_t* bench_drop(int n, mpc_val_t** xs) {
+    for (int i = 0; i < n; i++) { free(xs[i]); }
+    return NULL;
+}
+
+/* Repeats form until the input is at least n bytes */
+char* bench_input(size_t n, size_t* len) {
+    size_t step = strlen(form);
+    char* buf = malloc(n + step + 1);
+    *len = 0;
+    while (*len < n) {
+        memcpy(buf + *len, form, step);
+        *len += step;
+    }
+    buf[*len] = '\0';
+    return buf;
+}
+
+int bench_run(mpc_parser_t* Lispy, size_t n) {
+    size_t len;
+    char* input = bench_input(n, &len);
+
+    clock_t start = clock();
+    mpc_result_t r;
+    int ok = mpc_parse("<bench>", input, Lispy, &r);
+    double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    free(input);
+    if (!ok) {
+        mpc_err_print(r.error);
+        mpc_err_delete(r.error);
+        return 1;
+    }
+
+    printf("%12lu bytes %10.3fs", (unsigned long)len, secs);
+    if (secs > 0) { printf(" %10.2f MB/s", len / secs / (1024.0 * 1024.0)); }
+    putchar('\n');
+    fflush(stdout);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+
+    mpc_parser_t* Number = mpc_new("number");
+    mpc_parser_t* Symbol = mpc_new("symbol");
+    mpc_parser_t* Sexpr = mpc_new("sexpr");
+    mpc_parser_t* Qexpr = mpc_new("qexpr");
+    mpc_parser_t* Expr = mpc_new("expr");
+    mpc_parser_t* Lispy = mpc_new("lispy");
+
+    /* The same language as the grammar in lispy.c */
+    mpc_define(Number, mpc_tok(mpc_apply(mpc_re("-?[0-9]+"), mpcf_free)));
+    mpc_define(Symbol, mpc_tok(mpc_apply(mpc_or(11,
+        mpc_string("list"), mpc_string("head"), mpc_string("tail"),
+        mpc_string("join"), mpc_string("eval"), mpc_char('+'), mpc_char('-'),
+        mpc_char('*'), mpc_char('/'), mpc_char('%'), mpc_char('^')), mpcf_free)));
+    mpc_define(Sexpr, mpc_and(3, bench_drop,
+        mpc_sym("("), mpc_many(bench_drop, Expr), mpc_sym(")"), free, free));
+    mpc_define(Qexpr, mpc_and(3, bench_drop,
+        mpc_sym("{"), mpc_many(bench_drop, Expr), mpc_sym("}"), free, free));
+    mpc_define(Expr, mpc_or(4, Number, Symbol, Sexpr, Qexpr));
+    mpc_define(Lispy, mpc_whole(mpc_strip(mpc_many(bench_drop, Expr)), free));
+
+    int status = 0;
+    if (argc > 1) {
+        for (int i = 1; i < argc && !status; i++) {
+            status = bench_run(Lispy, strtoul(argv[i], NULL, 10));
+        }
+    } else {
+        /* 1 KB, 10 KB, ... 100 MB */
+        for (size_t n = 1000; n <= 100000000 && !status; n *= 10) {
+            status = bench_run(Lispy, n);
+        }
+    }
+
+    mpc_cleanup(6, Number, Symbol, Sexpr, Qexpr, Expr, Lispy);
+    return status;
+}
@@ -2,6 +2,8 @@
 #include <stdio.h> 
 #include <stdlib.h>
 #include <math.h>
+#include <stdint.h>
+#include <time.h>
 
 #ifdef _WIN32
 #include <string.h>
@@ -36,12 +38,21 @@ cc -std=c99 -Wall lispy.c mpc.c -ledit -lm -o lispy
 enum {LERR_DIV_ZERO, LERR_BAD_NUM, LERR_BAD_OP};
 enum {LVAL_NUM, LVAL_ERR, LVAL_SYM, LVAL_SEXPR, LVAL_QEXPR};
 
+/*
+// cell points at the first live element of the list. Popping the head
+// advances cell and off, so cell - off is the start of the allocation,
+// which has room for cap elements
+//
+// An lval* is a tagged word. Only lists, errors and numbers too big for
+// a fixnum point at a heap lval, see the tagging section below
+*/
 typedef struct lval{
     int type;
     long num;
     char* err;
-    char* sym;
     int count;
+    int cap;
+    int off;
     struct lval** cell;
 } lval;
 
@@ -50,59 +61,369 @@ void lval_print(lval* v);
 lval* lval_add(lval* v, lval* x);
 lval* lval_pop(lval* v, int i);
 lval* builtin(lval* a, char* func);
-lval* builtin_op(lval* a, char* op);
+lval* builtin_op(lval* a, char op);
 lval* lval_take(lval* v, int i);
 lval* lval_eval(lval* v);
+lval* lval_call_fixnums(lval* v);
+
+
+/*
+// lval arena
+//
+// While an arena is active every lval, cell array and error string is
+// bump allocated from it and lval_del does nothing, everything is
+// released at once by larena_end. main runs each top level form inside
+// an arena: nothing outlives the printed result, so nothing needs to be
+// copied out. Values allocated outside the arena must not be deleted
+// while it is active, they would be leaked rather than freed. With the
+// arena off (-p) larena_begin does nothing and every value comes from
+// and goes back to the pool, so the two can be measured against each other
+*/
+
+enum { LARENA_BLOCK_MIN = 64 * 1024, LARENA_ALIGN = 16 };
+
+typedef struct larena_block {
+    struct larena_block* next;
+    size_t size;
+    size_t used;
+} larena_block;
+
+#define LARENA_HEADER \
+    ((sizeof(larena_block) + LARENA_ALIGN - 1) & ~(size_t)(LARENA_ALIGN - 1))
+
+static larena_block* larena_blocks = NULL;
+static int larena_active = 0;
+static int larena_off = 0;
+static unsigned long larena_resets = 0;
+static size_t larena_peak = 0;
+
+static larena_block* larena_block_new(size_t size, larena_block* next) {
+    larena_block* b = malloc(LARENA_HEADER + size);
+    b->next = next;
+    b->size = size;
+    b->used = 0;
+    return b;
+}
+
+void* larena_alloc(size_t n) {
+    n = (n + LARENA_ALIGN - 1) & ~(size_t)(LARENA_ALIGN - 1);
+
+    larena_block* b = larena_blocks;
+    if (!b || b->size - b->used < n) {
+        size_t size = b ? b->size * 2 : LARENA_BLOCK_MIN;
+        if (size < n) { size = n; }
+        b = larena_blocks = larena_block_new(size, b);
+    }
+
+    void* x = (char*)b + LARENA_HEADER + b->used;
+    b->used += n;
+    return x;
+}
+
+void larena_begin(void) { larena_active = !larena_off; }
+
+/* Releases everything allocated since larena_begin */
+void larena_end(void) {
+    if (!larena_active) { return; }
+    larena_active = 0;
+    larena_resets++;
+    if (!larena_blocks) { return; }
+
+    /* If the form spilled over several blocks replace them with one big
+       enough for all of it, so the next form of that size doesn't spill */
+    size_t total = 0;
+    for (larena_block* b = larena_blocks; b; b = b->next) { total += b->used; }
+    if (total > larena_peak) { larena_peak = total; }
+
+    if (larena_blocks->next) {
+        size_t size = 0;
+        while (larena_blocks) {
+            larena_block* b = larena_blocks;
+            size += b->size;
+            larena_blocks = b->next;
+            free(b);
+        }
+        larena_blocks = larena_block_new(size, NULL);
+    }
+    larena_blocks->used = 0;
+}
+
+/*
+// lval pool
+//
+// lval structs and small cell arrays are recycled through free lists
+// instead of going back to the system allocator. Cell array capacities
+// are powers of two so each size class has its own free list. Arrays
+// larger than the biggest class use plain malloc/free. The interpreter
+// is single threaded so the free lists are global
+*/
+
+enum { LPOOL_CHUNK = 64, LCELL_CLASSES = 5 };
+
+typedef struct lpool_node {
+    struct lpool_node* next;
+} lpool_node;
+
+typedef struct {
+    lpool_node* free;
+    size_t size;
+    unsigned long hits;
+    unsigned long misses;
+} lpool;
+
+static lpool lval_pool = { NULL, sizeof(lval), 0, 0 };
+static lpool lcell_pools[LCELL_CLASSES] = {
+    { NULL, sizeof(lval*) *  1, 0, 0 },
+    { NULL, sizeof(lval*) *  2, 0, 0 },
+    { NULL, sizeof(lval*) *  4, 0, 0 },
+    { NULL, sizeof(lval*) *  8, 0, 0 },
+    { NULL, sizeof(lval*) * 16, 0, 0 },
+};
+
+static void* lpool_get(lpool* p) {
+    if (p->free) {
+        p->hits++;
+    } else {
+        /* Carve a new chunk into free list nodes, chunks are never returned */
+        p->misses++;
+        char* chunk = malloc(p->size * LPOOL_CHUNK);
+        for (int i = 0; i < LPOOL_CHUNK; i++) {
+            lpool_node* n = (lpool_node*)(chunk + p->size * i);
+            n->next = p->free;
+            p->free = n;
+        }
+    }
+    lpool_node* n = p->free;
+    p->free = n->next;
+    return n;
+}
+
+static void lpool_put(lpool* p, void* x) {
+    lpool_node* n = x;
+    n->next = p->free;
+    p->free = n;
+}
+
+/* Size class for a capacity of cap cells, -1 if it is too big to pool */
+static int lcell_class(int cap) {
+    int c = 0;
+    while (c < LCELL_CLASSES && (1 << c) < cap) { c++; }
+    return c < LCELL_CLASSES ? c : -1;
+}
+
+lval* lval_alloc(void) {
+    if (larena_active) { return larena_alloc(sizeof(lval)); }
+    return lpool_get(&lval_pool);
+}
+
+void lval_free(lval* v) {
+    if (larena_active) { return; }
+    lpool_put(&lval_pool, v);
+}
 
+/* Capacities are powers of two */
+static int lcell_capacity(int n) {
+    int c = 1;
+    while (c < n) { c *= 2; }
+    return c;
+}
+
+/* Allocates an array of cap cells, cap must come from lcell_capacity */
+lval** lcell_alloc(int cap) {
+    if (larena_active) { return larena_alloc(sizeof(lval*) * cap); }
+    int c = lcell_class(cap);
+    return c < 0 ? malloc(sizeof(lval*) * cap) : lpool_get(&lcell_pools[c]);
+}
+
+void lcell_free(lval** cell, int cap) {
+    if (larena_active || cap == 0) { return; }
+    int c = lcell_class(cap);
+    if (c < 0) { free(cell); } else { lpool_put(&lcell_pools[c], cell); }
+}
+
+/*
+// Makes room for at least n elements from v->cell onwards. Space freed by
+// head pops is reclaimed by sliding the list down when at least half of
+// the array is dead, otherwise the capacity doubles
+*/
+void lval_reserve(lval* v, int n) {
+    if (v->off + n <= v->cap) { return; }
+
+    lval** base = v->cell - v->off;
+
+    if (n <= v->cap && v->off >= v->count) {
+        memmove(base, v->cell, sizeof(lval*) * v->count);
+        v->cell = base;
+        v->off = 0;
+        return;
+    }
+
+    int cap = lcell_capacity(n > v->cap * 2 ? n : v->cap * 2);
+    lval** cell = lcell_alloc(cap);
+    if (v->count) { memcpy(cell, v->cell, sizeof(lval*) * v->count); }
+    lcell_free(base, v->cap);
+
+    v->cell = cell;
+    v->cap = cap;
+    v->off = 0;
+}
+
+void lpool_print_stats(FILE* f) {
+    fprintf(f, "lval pool: %lu hits, %lu misses\n", lval_pool.hits, lval_pool.misses);
+    for (int i = 0; i < LCELL_CLASSES; i++) {
+        fprintf(f, "cell pool %2d: %lu hits, %lu misses\n",
+            1 << i, lcell_pools[i].hits, lcell_pools[i].misses);
+    }
+    fprintf(f, "arena: %lu resets, %lu bytes peak\n",
+        larena_resets, (unsigned long)larena_peak);
+}
+
+/*
+// lval tagging
+//
+// The low two bits of an lval* say what it holds:
+//   ..1  a fixnum, the number shifted left by one
+//   .10  an interned symbol name, see lsym_intern
+//   .00  a pointer to a heap lval
+// Fixnums and symbols are never allocated, so lval_del ignores them.
+// Use lval_type, lval_num_of and lval_sym_of rather than ->type, ->num
+// unless the value is known to be a list or an error
+*/
+
+#define LVAL_TAG_FIXNUM 1
+#define LVAL_TAG_SYM    2
+
+#define LFIX_MAX (INTPTR_MAX >> 1)
+#define LFIX_MIN (INTPTR_MIN >> 1)
+
+static int lval_is_immediate(lval* v) { return ((uintptr_t)v & 3) != 0; }
+
+int lval_type(lval* v) {
+    if ((uintptr_t)v & LVAL_TAG_FIXNUM) { return LVAL_NUM; }
+    if ((uintptr_t)v & LVAL_TAG_SYM)    { return LVAL_SYM; }
+    return v->type;
+}
+
+long lval_num_of(lval* v) {
+    if ((uintptr_t)v & LVAL_TAG_FIXNUM) { return (long)((intptr_t)v >> 1); }
+    return v->num;
+}
+
+char* lval_sym_of(lval* v) {
+    return (char*)((uintptr_t)v & ~(uintptr_t)3);
+}
 
+/* Numbers outside the fixnum range are boxed */
 lval* lval_num(long x) {
-    lval* v = malloc(sizeof(lval));
+    if ((intptr_t)x >= LFIX_MIN && (intptr_t)x <= LFIX_MAX) {
+        return (lval*)(((uintptr_t)(intptr_t)x << 1) | LVAL_TAG_FIXNUM);
+    }
+    lval* v = lval_alloc();
     v->type = LVAL_NUM;
     v->num = x;
     return v;
 }
 
 lval* lval_err(char* m) {
-    lval* v = malloc(sizeof(lval));
+    lval* v = lval_alloc();
     v->type = LVAL_ERR;
-    v->err = malloc(sizeof(strlen(m) + 1));
+    v->err = larena_active ? larena_alloc(strlen(m) + 1) : malloc(strlen(m) + 1);
     strcpy(v->err, m);
     return v;
 }
 
+
+/*
+// symbol intern table
+//
+// Every symbol name is stored exactly once for the life of the program,
+// so two symbols are equal iff their sym pointers are equal and lval_del
+// never frees symbol strings. Open addressing, grown at half load
+*/
+
+static char** lsym_slots = NULL;
+static unsigned long lsym_size = 0;
+static unsigned long lsym_count = 0;
+
+static unsigned long lsym_hash(char* s) {
+    unsigned long h = 2166136261UL;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+static void lsym_grow(void) {
+    unsigned long size = lsym_size ? lsym_size * 2 : 64;
+    char** slots = calloc(size, sizeof(char*));
+
+    /* Rehash existing names into the larger table */
+    for (unsigned long i = 0; i < lsym_size; i++) {
+        if (!lsym_slots[i]) { continue; }
+        unsigned long j = lsym_hash(lsym_slots[i]) & (size - 1);
+        while (slots[j]) { j = (j + 1) & (size - 1); }
+        slots[j] = lsym_slots[i];
+    }
+
+    free(lsym_slots);
+    lsym_slots = slots;
+    lsym_size = size;
+}
+
+/* Returns the unique copy of s, adding it to the table if it is new */
+char* lsym_intern(char* s) {
+    if (lsym_count * 2 >= lsym_size) { lsym_grow(); }
+
+    unsigned long j = lsym_hash(s) & (lsym_size - 1);
+    while (lsym_slots[j]) {
+        if (strcmp(lsym_slots[j], s) == 0) { return lsym_slots[j]; }
+        j = (j + 1) & (lsym_size - 1);
+    }
+
+    lsym_slots[j] = malloc(strlen(s) + 1);
+    strcpy(lsym_slots[j], s);
+    lsym_count++;
+    return lsym_slots[j];
+}
+
+/* Interned names come from malloc so their low bits are free for the tag */
 lval* lval_sym(char* s) {
-    lval* v = malloc(sizeof(lval));
-    v->type = LVAL_SYM;
-    v->sym = malloc(sizeof(strlen(s) + 1));
-    strcpy(v->sym, s);
-    return v;
+    return (lval*)((uintptr_t)lsym_intern(s) | LVAL_TAG_SYM);
 }
 
 lval* lval_sexpr(void) {
-    lval* v = malloc(sizeof(lval));
+    lval* v = lval_alloc();
     v->type = LVAL_SEXPR;
     v->count = 0;
+    v->cap = 0;
+    v->off = 0;
     v->cell = NULL;
     return v;
 }
 
 lval* lval_qexpr(void) {
-    lval* v = malloc(sizeof(lval));
+    lval* v = lval_alloc();
     v->type = LVAL_QEXPR;
     v->count = 0;
+    v->cap = 0;
+    v->off = 0;
     v->cell = NULL;
     return v;
 }
 
 void lval_del(lval* v) {
 
+    /* Arena values are all released together by larena_end,
+       fixnums and symbols were never allocated */
+    if (larena_active || lval_is_immediate(v)) { return; }
+
     switch (v->type) {
-        /* Do nothing special for number type */
+        /* Do nothing special for boxed numbers */
         case LVAL_NUM: break;
 
-        /* for err or sym free the string data */
+        /* for err free the string data */
         case LVAL_ERR: free(v->err); break;
-        case LVAL_SYM: free(v->sym); break;
 
         /* if Sexpr then delte all elments inside */
         case LVAL_QEXPR:
@@ -111,14 +432,17 @@ void lval_del(lval* v) {
                 lval_del(v->cell[i]);
             }
 
-            free(v->cell);
+            lcell_free(v->cell - v->off, v->cap);
         break;
     }
 
-    /* Free the memory allocated for the lval struct itself */
-    free(v);
+    /* Return the lval struct itself to the pool */
+    lval_free(v);
 }
 
+/* Tag ids for the grammar rules, looked up once in main */
+static int tag_number, tag_symbol, tag_sexpr, tag_qexpr;
+
 lval* lval_read_num(mpc_ast_t* t) {
     errno = 0;
     long x = strtol(t->contents, NULL, 10);
@@ -128,14 +452,14 @@ lval* lval_read_num(mpc_ast_t* t) {
 
 lval* lval_read(mpc_ast_t* t) {
     /* If Symbol or Number return conversion to that type */
-    if (strstr(t->tag, "number")) { return lval_read_num(t); }
-    if (strstr(t->tag, "symbol")) { return lval_sym(t->contents); }
+    if (mpc_ast_has_tag(t, tag_number)) { return lval_read_num(t); }
+    if (mpc_ast_has_tag(t, tag_symbol)) { return lval_sym(t->contents); }
 
     /* If root (>) or sexpr then create empty list */
     lval* x = NULL;
-    if (strcmp(t->tag, ">") == 0) { x = lval_sexpr(); }
-    if (strstr(t->tag, "sexpr"))  { x = lval_sexpr(); }
-    if (strstr(t->tag, "qexpr"))  { x = lval_qexpr(); }
+    if (strcmp(t->tag, ">") == 0)      { x = lval_sexpr(); }
+    if (mpc_ast_has_tag(t, tag_sexpr)) { x = lval_sexpr(); }
+    if (mpc_ast_has_tag(t, tag_qexpr)) { x = lval_qexpr(); }
 
     /* FIll this list with any valid expression contained within */
     for (int i = 0; i < t->children_num; i++) {
@@ -152,73 +476,364 @@ lval* lval_read(mpc_ast_t* t) {
 
 
 /*
-// Increases the count of the lval list by one, then uses
-// realloc to reallocate the amount of space required by v->cell
+// direct reader
+//
+// Reads the lispy grammar straight from the input string into lvals in a
+// single pass, without building an mpc_ast_t. It accepts exactly what the
+// mpc grammar in main accepts, token for token, and returns NULL for
+// anything else so the caller can fall back to mpc for the error message
+//
+// Evaluating, printing and deleting a value all recurse into its lists,
+// so a list nested deeper than LREAD_DEPTH_MAX is read as an error in
+// its place, like a number out of range, rather than overflow the stack
+*/
+
+enum { LREAD_DEPTH_MAX = 10000 };
+
+static int lread_space(char c) {
+    return c == ' ' || c == '\f' || c == '\n' || c == '\r' || c == '\t' || c == '\v';
+}
+
+static void lread_skip(char** s) {
+    while (lread_space(**s)) { (*s)++; }
+}
+
+static char* lread_keywords[] = { "list", "head", "tail", "join", "eval" };
+
+static lval* lread_expr(char** s, int depth);
+
+/* Reads exprs until close, which must follow, s is past the opening paren */
+static lval* lread_list(char** s, lval* x, char close, int depth) {
+    lread_skip(s);
+    while (**s != close) {
+        lval* y = lread_expr(s, depth);
+        if (!y) { lval_del(x); return NULL; }
+        lval_add(x, y);
+    }
+    (*s)++;
+    lread_skip(s);
+    return x;
+}
+
+/* Skips a list nested too deep by its brackets alone, NULL if it never closes */
+static lval* lread_too_deep(char** s) {
+    char* p = *s;
+    int open = 0;
+    do {
+        if (!*p) { return NULL; }
+        if (*p == '(' || *p == '{') { open++; }
+        if (*p == ')' || *p == '}') { open--; }
+        p++;
+    } while (open > 0);
+    *s = p;
+    lread_skip(s);
+    return lval_err("expression nested too deeply");
+}
+
+/* Reads one expr inside depth open lists */
+static lval* lread_expr(char** s, int depth) {
+    char* p = *s;
+
+    /* number : /-?[0-9]+/ */
+    char* d = p + (*p == '-');
+    if (*d >= '0' && *d <= '9') {
+        char* end = d;
+        while (*end >= '0' && *end <= '9') { end++; }
+        errno = 0;
+        long x = strtol(p, NULL, 10);
+        *s = end;
+        lread_skip(s);
+        return errno != ERANGE ? lval_num(x) : lval_err("invalid number");
+    }
+
+    /* symbol : the keywords, then the single character operators */
+    for (int i = 0; i < 5; i++) {
+        if (strncmp(p, lread_keywords[i], 4) == 0) {
+            *s = p + 4;
+            lread_skip(s);
+            return lval_sym(lread_keywords[i]);
+        }
+    }
+    if (*p && strchr("+-*/%^", *p)) {
+        char op[2] = { *p, '\0' };
+        *s = p + 1;
+        lread_skip(s);
+        return lval_sym(op);
+    }
+
+    /* sexpr and qexpr */
+    if ((*p == '(' || *p == '{') && depth >= LREAD_DEPTH_MAX) { return lread_too_deep(s); }
+    if (*p == '(') { *s = p + 1; return lread_list(s, lval_sexpr(), ')', depth + 1); }
+    if (*p == '{') { *s = p + 1; return lread_list(s, lval_qexpr(), '}', depth + 1); }
+
+    return NULL;
+}
+
+/*
+// Reads the next top level expression and leaves s after it, NULL at the
+// end of input or on a syntax error, which the caller tells apart by *s.
+// A failed form leaves s at its start, since reading it may have moved s
+// all the way to the end of an unterminated list
+*/
+lval* lval_read_next(char** s) {
+    lread_skip(s);
+    if (!**s) { return NULL; }
+    char* start = *s;
+    lval* x = lread_expr(s, 0);
+    if (!x) { *s = start; }
+    return x;
+}
+
+/* Reads a whole line as an S expression, like lval_read on the mpc root */
+lval* lval_read_str(char* s) {
+    lval* x = lval_sexpr();
+    lread_skip(&s);
+    while (*s) {
+        lval* y = lread_expr(&s, 1);
+        if (!y) { lval_del(x); return NULL; }
+        lval_add(x, y);
+    }
+    return x;
+}
+
+/*
+// incremental reader
+//
+// The REPL reads a form which spans several lines a line at a time. The
+// lists still open at the end of a line are kept and the next line goes on
+// filling them, so no line is read twice and a form of n lines costs O(n).
+// A newline always ends a token, so tokens never span lines. A syntax
+// error ends the form at once. The lines are also kept in buf, which only
+// mpc reads, to report the error. A list nested too deep is skipped by its
+// brackets, which may span lines too, and read as an error in its place
+*/
+
+typedef struct {
+    lval** open;
+    char* close;
+    int depth;
+    int cap;
+    int error;
+    int skip;
+    char* buf;
+    size_t len;
+    size_t size;
+} lreader;
+
+enum { LREAD_DONE, LREAD_MORE, LREAD_ERROR };
+
+static void lreader_push(lreader* r, lval* x, char close) {
+    if (r->depth == r->cap) {
+        r->cap = r->cap ? r->cap * 2 : 16;
+        r->open = realloc(r->open, sizeof(lval*) * r->cap);
+        r->close = realloc(r->close, r->cap);
+    }
+    r->open[r->depth] = x;
+    r->close[r->depth] = close;
+    r->depth++;
+}
+
+static void lreader_keep(lreader* r, char* line) {
+    size_t n = strlen(line);
+    if (r->len + n + 2 > r->size) {
+        while (r->len + n + 2 > r->size) { r->size = r->size ? r->size * 2 : 4096; }
+        r->buf = realloc(r->buf, r->size);
+    }
+    if (r->len) { r->buf[r->len++] = '\n'; }
+    memcpy(r->buf + r->len, line, n + 1);
+    r->len += n;
+}
+
+/* Starts a form, which like lval_read_str reads as an S expression */
+void lreader_begin(lreader* r) {
+    r->depth = 0;
+    r->error = 0;
+    r->skip = 0;
+    r->len = 0;
+    lreader_push(r, lval_sexpr(), '\0');
+}
+
+/* Reads the next line of the form, it is finished once this returns LREAD_DONE */
+int lreader_feed(lreader* r, char* s) {
+    lreader_keep(r, s);
+
+    while (1) {
+        lread_skip(&s);
+        if (!*s) { return r->depth > 1 || r->skip ? LREAD_MORE : LREAD_DONE; }
+
+        if (r->skip) {
+            if (*s == '(' || *s == '{') { r->skip++; }
+            if ((*s == ')' || *s == '}') && --r->skip == 0) {
+                lval_add(r->open[r->depth - 1], lval_err("expression nested too deeply"));
+            }
+            s++;
+            continue;
+        }
+        if ((*s == '(' || *s == '{') && r->depth >= LREAD_DEPTH_MAX) {
+            s++;
+            r->skip = 1;
+            continue;
+        }
+        if (*s == r->close[r->depth - 1]) {
+            s++;
+            r->depth--;
+            lval_add(r->open[r->depth - 1], r->open[r->depth]);
+            continue;
+        }
+        if (*s == '(') { s++; lreader_push(r, lval_sexpr(), ')'); continue; }
+        if (*s == '{') { s++; lreader_push(r, lval_qexpr(), '}'); continue; }
+
+        lval* y = lread_expr(&s, r->depth);
+        if (!y) {
+            r->error = 1;
+            return LREAD_ERROR;
+        }
+        lval_add(r->open[r->depth - 1], y);
+    }
+}
+
+/* The finished form, or NULL after an error or for a form left unfinished */
+lval* lreader_end(lreader* r) {
+    if (!r->error && r->depth == 1) {
+        r->depth = 0;
+        return r->open[0];
+    }
+    while (r->depth > 0) { lval_del(r->open[--r->depth]); }
+    return NULL;
+}
+
+/*
+// Increases the count of the lval list by one, using lval_reserve
+// to grow v->cell geometrically when it is full
 // New space is used to store extra lval
 */
 lval* lval_add(lval* v, lval* x) {
+    lval_reserve(v, v->count + 1);
+    v->cell[v->count] = x;
     v->count++;
-    v->cell = realloc(v->cell, sizeof(lval) * v->count);
-    v->cell[v->count -1] = x;
     return v;
 }
 
 
 /*
-// Pops each item from y and adds it to x until y is empty, and 
+// Moves every item of y onto the end of x with a single copy, and 
 // then deletes y and returns x. Used by builtin_join function
 */
 lval* lval_join(lval* x, lval* y) {
 
-    /* For each cell in y, take it and add it to x */
-    while (y->count) {
-        x = lval_add(x, lval_pop(y, 0));
-    }
+    /* Splice y's cells onto the end of x */
+    lval_reserve(x, x->count + y->count);
+    if (y->count) { memcpy(&x->cell[x->count], y->cell, sizeof(lval*) * y->count); }
+    x->count += y->count;
+    y->count = 0;
 
     /* Delete emtpy y, return x */
     lval_del(y);
     return x;
 }
 
-void lval_expr_print(lval* v, char open, char close) {
-    putchar(open);
+/*
+// output writer
+//
+// lval_write serializes into an lwriter rather than calling printf for
+// every atom, and the writer flushes to its FILE whenever its buffer fills
+*/
+
+typedef struct {
+    char* buf;
+    size_t len;
+    size_t cap;
+    FILE* out;
+} lwriter;
+
+enum { LWRITER_BUFFER = 64 * 1024 };
+
+static char lout_buf[LWRITER_BUFFER];
+
+/* Writer behind lval_print and lval_println */
+static lwriter lout = { lout_buf, 0, LWRITER_BUFFER, NULL };
+
+void lwriter_flush(lwriter* w) {
+    if (w->out && w->len) {
+        fwrite(w->buf, 1, w->len, w->out);
+        w->len = 0;
+    }
+}
+
+static void lwriter_write(lwriter* w, const char* s, size_t n) {
+    if (w->len + n > w->cap) {
+        lwriter_flush(w);
+        if (n > w->cap) { fwrite(s, 1, n, w->out); return; }
+    }
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static void lwriter_putc(lwriter* w, char c) {
+    if (w->len < w->cap) { w->buf[w->len++] = c; return; }
+    lwriter_write(w, &c, 1);
+}
+
+static void lwriter_puts(lwriter* w, const char* s) {
+    lwriter_write(w, s, strlen(s));
+}
+
+/* Formats digits backwards into a small buffer instead of using printf */
+static void lwriter_num(lwriter* w, long x) {
+    char tmp[24];
+    char* p = tmp + sizeof(tmp);
+    unsigned long u = x < 0 ? 0UL - (unsigned long)x : (unsigned long)x;
+    do {
+        *--p = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (x < 0) { *--p = '-'; }
+    lwriter_write(w, p, (size_t)(tmp + sizeof(tmp) - p));
+}
+
+void lval_write(lwriter* w, lval* v);
+
+void lval_expr_write(lwriter* w, lval* v, char open, char close) {
+    lwriter_putc(w, open);
     for (int i = 0; i < v->count; i++) {
 
         /* Print Value contained within */
-        lval_print(v->cell[i]);
+        lval_write(w, v->cell[i]);
 
         /* Don't print trailing space if laste element */
         if (i != (v->count-1)) {
-            putchar(' ');
+            lwriter_putc(w, ' ');
         }
     }
 
-    putchar(close);
+    lwriter_putc(w, close);
 }
 
-void lval_print(lval* v) {
-    switch (v->type) {
+void lval_write(lwriter* w, lval* v) {
+    switch (lval_type(v)) {
 
-    case LVAL_NUM: printf("%li", v->num); break;
-    case LVAL_ERR: printf("Error: %s", v->err); break;
-    case LVAL_SYM: printf("%s", v->sym); break;
-    case LVAL_SEXPR: lval_expr_print(v, '(', ')'); break;
-    case LVAL_QEXPR: lval_expr_print(v, '{', '}'); break;
+    case LVAL_NUM: lwriter_num(w, lval_num_of(v)); break;
+    case LVAL_ERR: lwriter_puts(w, "Error: "); lwriter_puts(w, v->err); break;
+    case LVAL_SYM: lwriter_puts(w, lval_sym_of(v)); break;
+    case LVAL_SEXPR: lval_expr_write(w, v, '(', ')'); break;
+    case LVAL_QEXPR: lval_expr_write(w, v, '{', '}'); break;
     }
 }
 
-void lval_println(lval* v) { lval_print(v); putchar('\n'); }
+/* Buffered on stdout, call lwriter_flush(&lout) before anything else writes */
+void lval_print(lval* v) {
+    if (!lout.out) { lout.out = stdout; }
+    lval_write(&lout, v);
+}
 
-lval* lval_eval_sexpr(lval* v){ 
+void lval_println(lval* v) { lval_print(v); lwriter_putc(&lout, '\n'); }
 
-    /* Evalueate Children */
-    for (int i = 0; i < v->count; i++) {
-        v->cell[i] = lval_eval(v->cell[i]);
-    }
+/* Applies an S expression whose children have already been evaluated */
+lval* lval_call(lval* v) {
 
     /* error checking */
     for (int i = 0; i < v->count; i++) {
-        if (v->cell[i]->type == LVAL_ERR) { return lval_take(v, i); }
+        if (lval_type(v->cell[i]) == LVAL_ERR) { return lval_take(v, i); }
     }
 
     /* Empty expression catch */
@@ -229,21 +844,32 @@ lval* lval_eval_sexpr(lval* v){
 
     /* Ensure first Element is a Symbol */
     lval* f = lval_pop(v, 0);
-    if (f->type != LVAL_SYM) {
+    if (lval_type(f) != LVAL_SYM) {
         lval_del(f); lval_del(v);
         return lval_err("S-expression does not start with symbol!");
     }
 
     /* Call Builtin with operator */
-    lval* result = builtin(v, f->sym);
+    lval* result = builtin(v, lval_sym_of(f));
     lval_del(f);
     return result;
 }
 
+lval* lval_eval_sexpr(lval* v){ 
+
+    /* Evalueate Children */
+    for (int i = 0; i < v->count; i++) {
+        v->cell[i] = lval_eval(v->cell[i]);
+    }
+
+    lval* x = lval_call_fixnums(v);
+    return x ? x : lval_call(v);
+}
+
 /* checks if S expression and then passed to lval_eval_sexpr */
 lval* lval_eval(lval* v) {
     /* Evaluate sexpressions */
-    if (v->type == LVAL_SEXPR) { return lval_eval_sexpr(v); }
+    if (lval_type(v) == LVAL_SEXPR) { return lval_eval_sexpr(v); }
     /* ALl other eval types remain the same */
     return v;
 }
@@ -259,15 +885,24 @@ lval* lval_pop(lval* v, int i) {
     /* Find item at "i" */
     lval* x = v->cell[i];
 
-    /*shift memory after the item at i over the top */
-    memmove(&v->cell[i], &v->cell[i+1],
-            sizeof(lval*) * (v->count-i-1));
+    if (i == 0) {
+        /* Popping the head just moves the start of the list */
+        v->cell++;
+        v->off++;
+    } else {
+        /*shift memory after the item at i over the top */
+        memmove(&v->cell[i], &v->cell[i+1],
+                sizeof(lval*) * (v->count-i-1));
+    }
 
     /* Decrease the count of items in the list */
     v->count--;
 
-    /* Reallocate the memory used */
-    v->cell = realloc(v->cell, sizeof(lval*) * v->count);
+    /* An empty list can reuse its whole array */
+    if (v->count == 0) {
+        v->cell -= v->off;
+        v->off = 0;
+    }
     return x;
 }
 
@@ -292,12 +927,12 @@ lval* lval_take(lval* v, int i) {
 /* Takes a Q expression and returns a Q expression with only the first element */
 lval* builtin_head(lval* a) {
     LASSERT(a, a->count == 1, "function head passed in too many arguments");
-    LASSERT(a, a->cell[0]->type == LVAL_QEXPR, "function head passed in wrong argument type");
+    LASSERT(a, lval_type(a->cell[0]) == LVAL_QEXPR, "function head passed in wrong argument type");
     LASSERT(a, a->cell[0]->count != 0, "function head passed in {}"); // if Q expresion is empty err is triggered
 
     lval* v = lval_take(a, 0);
     while(v->count > 1) {
-        lval_del(lval_pop(v,1));
+        lval_del(lval_pop(v, v->count-1));
     }
     return v;
 }
@@ -305,7 +940,7 @@ lval* builtin_head(lval* a) {
 /* Takes a Q expression and returns a Q expression with the first element removed */
 lval* builtin_tail(lval* a) {
     LASSERT(a, a->count == 1, "function head passed in too many arguments");
-    LASSERT(a, a->cell[0]->type == LVAL_QEXPR, "function head passed in wrong argument type");
+    LASSERT(a, lval_type(a->cell[0]) == LVAL_QEXPR, "function head passed in wrong argument type");
     LASSERT(a, a->cell[0]->count != 0, "function head passed in {}"); // if Q expresion is empty err is triggered
 
     lval* v = lval_take(a, 0);
@@ -322,7 +957,7 @@ lval* builtin_list(lval* a) {
 /* Takes a Q expression and evaluates it as if it were an S expression using lval_eval*/
 lval* builtin_eval(lval* a) {
     LASSERT(a, a->count == 1, "function head passed in too many arguments");
-    LASSERT(a, a->cell[0]->type == LVAL_QEXPR, "function head passed in wrong argument type");
+    LASSERT(a, lval_type(a->cell[0]) == LVAL_QEXPR, "function head passed in wrong argument type");
 
     lval* x = lval_take(a, 0);
     x->type = LVAL_SEXPR;
@@ -332,7 +967,7 @@ lval* builtin_eval(lval* a) {
 /* Takes multiple Q expression and returns a Q expression with them conjoined together*/
 lval* builtin_join(lval* a) {
     for (int i = 0; i < a->count; i++) {
-        LASSERT(a, a->cell[i]->type == LVAL_QEXPR, "Function join passed wrong type");
+        LASSERT(a, lval_type(a->cell[i]) == LVAL_QEXPR, "Function join passed wrong type");
     }
 
     lval* x = lval_pop(a,0);
@@ -344,64 +979,301 @@ lval* builtin_join(lval* a) {
     return x;
 }
 
-lval* builtin_op(lval* a, char* op) {
+/* Folds n number arguments with op, the arguments are not consumed */
+lval* lval_arith(lval** args, int n, char op) {
 
     /* Ensure all arguments are numbers */
-    for (int i = 0; i < a->count; i++) {
-        if (a->cell[i]->type != LVAL_NUM) {
-            lval_del(a);
+    for (int i = 0; i < n; i++) {
+        if (lval_type(args[i]) != LVAL_NUM) {
             return lval_err("Cannot operate on a non number lmao!");
         }
     }
 
-    /*Pop the first element */
-    lval* x = lval_pop(a, 0);
+    /* Work on unboxed values, only the result is turned back into an lval */
+    long x = lval_num_of(args[0]);
 
     /* if no argyments and sub then perform unary negation */
-    if ((strcmp(op, "-") == 0) && a->count == 0) {
-        x->num = -x->num;
+    if (op == '-' && n == 1) {
+        x = -x;
     }
 
     /* do while elements still remain */
-    while (a->count > 0) {
-
-        /* pop the next element */
-        lval* y = lval_pop(a, 0);
-
-        if (strcmp(op, "+") == 0) { return lval_num(x->num + y->num); }
-        if (strcmp(op, "-") == 0) { return lval_num(x->num - y->num); }
-        if (strcmp(op, "*") == 0) { return lval_num(x->num * y->num); }
-        if (strcmp(op, "%") == 0) { return lval_num(x->num % y->num); }
-        if (strcmp(op, "^") == 0) { return lval_num(pow(x->num, y->num)); }
-        if (strcmp(op, "/") == 0) {
-            if (y->num == 0) {
-                lval_del(x); lval_del(y);
-                x = lval_err("Division by zero!"); 
-                break;
-            } else {
-                x->num /= y->num;
+    for (int i = 1; i < n; i++) {
+
+        long y = lval_num_of(args[i]);
+
+        /* op was resolved by the caller so this is a single jump */
+        switch (op) {
+        case '+': x += y; break;
+        case '-': x -= y; break;
+        case '*': x *= y; break;
+        case '^': x = pow(x, y); break;
+        case '%':
+        case '/':
+            if (y == 0) {
+                return lval_err("Division by zero!");
             }
+            if (op == '%') { x %= y; } else { x /= y; }
+            break;
         }
-
-        lval_del(y);
     }
 
+    return lval_num(x);
+}
+
+lval* builtin_op(lval* a, char op) {
+    lval* x = lval_arith(a->cell, a->count, op);
     lval_del(a);
-    return x;   
+    return x;
+}
+
+lval* builtin_add(lval* a) { return builtin_op(a, '+'); }
+lval* builtin_sub(lval* a) { return builtin_op(a, '-'); }
+lval* builtin_mul(lval* a) { return builtin_op(a, '*'); }
+lval* builtin_div(lval* a) { return builtin_op(a, '/'); }
+lval* builtin_mod(lval* a) { return builtin_op(a, '%'); }
+lval* builtin_pow(lval* a) { return builtin_op(a, '^'); }
+
+
+/*
+// builtin registry
+//
+// Maps an interned builtin name to its function pointer. The table is a
+// perfect hash over the interned name pointers: lbuiltins_init searches
+// for a seed under which every builtin lands in its own slot, so a lookup
+// is one hash and one pointer compare
+*/
+
+typedef lval*(*lbuiltin)(lval*);
+
+typedef struct {
+    char* name;
+    lbuiltin func;
+} lbuiltin_entry;
+
+enum { LBUILTIN_SLOTS = 32 };
+
+static lbuiltin_entry lbuiltins[LBUILTIN_SLOTS];
+static unsigned long lbuiltin_seed = 0;
+
+static unsigned long lbuiltin_hash(char* s, unsigned long seed) {
+    /* Mix the pointer bits, names are interned so the address is the key */
+    unsigned long h = ((unsigned long)(size_t)s ^ seed) * 2654435761UL;
+    return (h ^ (h >> 15)) & (LBUILTIN_SLOTS - 1);
+}
+
+void lbuiltins_init(void) {
+    lbuiltin_entry defs[] = {
+        {"list", builtin_list}, {"head", builtin_head},
+        {"tail", builtin_tail}, {"join", builtin_join},
+        {"eval", builtin_eval},
+        {"+", builtin_add}, {"-", builtin_sub}, {"*", builtin_mul},
+        {"/", builtin_div}, {"%", builtin_mod}, {"^", builtin_pow},
+    };
+    int n = sizeof(defs) / sizeof(defs[0]);
+
+    for (int i = 0; i < n; i++) { defs[i].name = lsym_intern(defs[i].name); }
+
+    /* Try seeds until no two builtins share a slot */
+    for (lbuiltin_seed = 0; ; lbuiltin_seed++) {
+        memset(lbuiltins, 0, sizeof(lbuiltins));
+        int i;
+        for (i = 0; i < n; i++) {
+            lbuiltin_entry* e = &lbuiltins[lbuiltin_hash(defs[i].name, lbuiltin_seed)];
+            if (e->name) { break; }
+            *e = defs[i];
+        }
+        if (i == n) { return; }
+    }
+}
+
+/* name must be interned, as every LVAL_SYM sym is */
+lbuiltin lbuiltin_lookup(char* name) {
+    lbuiltin_entry* e = &lbuiltins[lbuiltin_hash(name, lbuiltin_seed)];
+    if (e->name == name) { return e->func; }
+    return NULL;
 }
 
 /* Calls the correct subfunction depeding on what symbol is encountered */
 lval* builtin(lval* a, char* func) {
-    if (strcmp("list", func) == 0) { return builtin_list(a); }
-    if (strcmp("head", func) == 0) { return builtin_head(a); }
-    if (strcmp("tail", func) == 0) { return builtin_tail(a); }
-    if (strcmp("join", func) == 0) { return builtin_join(a); }
-    if (strcmp("eval", func) == 0) { return builtin_eval(a); }
-    if (strcmp("+-/*^%", func))    { return builtin_op(a, func); }
+    lbuiltin f = lbuiltin_lookup(func);
+    if (f) { return f(a); }
     lval_del(a);
     return lval_err("Unkown function");
 }
 
+/*
+// Adds, subtracts or multiplies fixnums straight out of an evaluated S
+// expression, with one tag test for all of them and no argument list.
+// Returns NULL without touching v for anything else, which goes through
+// lval_call and the builtins as usual
+*/
+lval* lval_call_fixnums(lval* v) {
+    if (v->count < 2 || lval_type(v->cell[0]) != LVAL_SYM) { return NULL; }
+
+    lbuiltin f = lbuiltin_lookup(lval_sym_of(v->cell[0]));
+    char op = f == builtin_add ? '+' : f == builtin_sub ? '-' : f == builtin_mul ? '*' : 0;
+    if (!op) { return NULL; }
+
+    uintptr_t tags = LVAL_TAG_FIXNUM;
+    for (int i = 1; i < v->count; i++) { tags &= (uintptr_t)v->cell[i]; }
+    if (!tags) { return NULL; }
+
+    long x = (long)((intptr_t)v->cell[1] >> 1);
+    if (op == '-' && v->count == 2) { x = -x; }
+    for (int i = 2; i < v->count; i++) {
+        long y = (long)((intptr_t)v->cell[i] >> 1);
+        switch (op) {
+        case '+': x += y; break;
+        case '-': x -= y; break;
+        case '*': x *= y; break;
+        }
+    }
+
+    lval_del(v);
+    return lval_num(x);
+}
+
+
+/*
+// batch mode
+//
+// Evaluates every top level expression of a file, or of stdin for "-",
+// printing each result on its own line. Unlike the REPL, where a line is
+// one S expression, a file is a sequence of forms so "+ 1 2" is three of
+// them. The input is read whole and fed to the direct reader; on a syntax
+// error mpc parses the input again to report it, and evaluation stops
+*/
+
+static char* lbatch_slurp(FILE* f, size_t* len) {
+    size_t cap = 64 * 1024;
+    char* buf = malloc(cap);
+    *len = 0;
+    while (1) {
+        *len += fread(buf + *len, 1, cap - *len - 1, f);
+        if (*len < cap - 1) { break; }
+        cap *= 2;
+        buf = realloc(buf, cap);
+    }
+    buf[*len] = '\0';
+    return buf;
+}
+
+int lbatch_run(char* filename, mpc_parser_t* Lispy) {
+    int stdio = strcmp(filename, "-") == 0;
+    FILE* f = stdio ? stdin : fopen(filename, "rb");
+    if (!f) {
+        fprintf(stderr, "lispy: cannot open %s\n", filename);
+        return 1;
+    }
+
+    clock_t start = clock();
+    size_t len;
+    char* input = lbatch_slurp(f, &len);
+    if (!stdio) { fclose(f); }
+
+    unsigned long forms = 0;
+    int status = 0;
+    char* s = input;
+    while (1) {
+        larena_begin();
+        lval* x = lval_read_next(&s);
+        if (!x) {
+            larena_end();
+            break;
+        }
+        x = lval_eval(x);
+        lval_println(x);
+        lval_del(x);
+        larena_end();
+        forms++;
+    }
+
+    /* Results went out in large chunks through lout, push out the rest */
+    lwriter_flush(&lout);
+
+    /* Stopped short of the end, let mpc explain why */
+    if (s != input + len) {
+        mpc_result_t r;
+        if (mpc_parse(stdio ? "<stdin>" : filename, input, Lispy, &r)) {
+            /* mpc stops at a NUL byte too, so it has nothing to say */
+            mpc_ast_delete(r.output);
+            fprintf(stderr, "%s: error: NUL byte at offset %lu, %lu bytes not read\n",
+                stdio ? "<stdin>" : filename, (unsigned long)(s - input),
+                (unsigned long)(input + len - s));
+        } else {
+            mpc_err_print_to(r.error, stderr);
+            mpc_err_delete(r.error);
+        }
+        status = 1;
+    }
+
+    free(input);
+
+    double secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+    fprintf(stderr, "lispy: %lu forms, %lu bytes in %.3fs cpu",
+        forms, (unsigned long)len, secs);
+    if (secs > 0) {
+        fprintf(stderr, " (%.0f forms/s, %.2f MB/s)",
+            forms / secs, len / secs / (1024.0 * 1024.0));
+    }
+    fputc('\n', stderr);
+    return status;
+}
+
+/*
+// saved grammar
+//
+// Parsing the grammar below takes most of the time lispy spends starting up,
+// so it is loaded from lispy_grammar.h instead. Running lispy -g rewrites
+// that header; until it is run again after a change to the grammar, the
+// saved copy no longer matches and the grammar is parsed as before
+*/
+
+static const char* lispy_grammar =
+"                                                            \
+    number      : /-?[0-9]+/;                                \
+    symbol      : \"list\" | \"head\" | \"tail\" | \"join\"| \
+                \"eval\" |'+' | '-' | '*' | '/' | '%' | '^'; \
+    sexpr       : '(' <expr>* ')';                           \
+    qexpr       : '{' <expr>* '}';                           \
+    expr        : <number> | <symbol> | <sexpr> | <qexpr>;   \
+    lispy       : /^/ <expr>* /$/;                           \
+";
+
+#include "lispy_grammar.h"
+
+int lgrammar_write(FILE* out, mpc_parser_t* Number, mpc_parser_t* Symbol,
+    mpc_parser_t* Sexpression, mpc_parser_t* Qexpression,
+    mpc_parser_t* Expression, mpc_parser_t* Lispy) {
+
+    FILE* tmp = tmpfile();
+    if (!tmp) {
+        fprintf(stderr, "lispy: cannot open a temporary file\n");
+        return 1;
+    }
+
+    mpc_err_t* err = mpca_lang_save(tmp, MPCA_LANG_DEFAULT, lispy_grammar,
+        Number, Symbol, Sexpression, Qexpression, Expression, Lispy);
+    if (err) {
+        mpc_err_print(err);
+        mpc_err_delete(err);
+        fclose(tmp);
+        return 1;
+    }
+
+    fputs("/* Written by lispy -g from the grammar in lispy.c, do not edit */\n\n", out);
+    fputs("static const unsigned char lispy_grammar_saved[] = {", out);
+    rewind(tmp);
+    int c;
+    for (long n = 0; (c = fgetc(tmp)) != EOF; n++) {
+        fprintf(out, "%s0x%02x", n % 12 ? ", " : (n ? ",\n    " : "\n    "), c);
+    }
+    fputs("\n};\n", out);
+    fclose(tmp);
+    return 0;
+}
+
 int main(int argc, char** argv) {
 
     mpc_parser_t* Number        = mpc_new("number");
@@ -411,41 +1283,106 @@ int main(int argc, char** argv) {
     mpc_parser_t* Expression    = mpc_new("expr");
     mpc_parser_t* Lispy         = mpc_new("lispy");
 
-    mpca_lang(MPCA_LANG_DEFAULT,
-    "                                                            \
-        number      : /-?[0-9]+/;                                \
-        symbol      : \"list\" | \"head\" | \"tail\" | \"join\"| \
-                    \"eval\" |'+' | '-' | '*' | '/' | '%' | '^'; \
-        sexpr       : '(' <expr>* ')';                           \
-        qexpr       : '{' <expr>* '}';                           \
-        expr        : <number> | <symbol> | <sexpr> | <qexpr>;   \
-        lispy       : /^/ <expr>* /$/;                           \
-    ",
-    Number, Symbol, Sexpression, Qexpression, Expression, Lispy);
+    /* -s prints allocator statistics on exit
+       -p allocates every value from the pool, without an arena per form
+       -g writes the saved grammar for lispy_grammar.h to stdout
+       a file name, or - for stdin, runs it in batch mode instead of the REPL */
+    int stats = 0;
+    int save = 0;
+    char* script = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0) { stats = 1; continue; }
+        if (strcmp(argv[i], "-p") == 0) { larena_off = 1; continue; }
+        if (strcmp(argv[i], "-g") == 0) { save = 1; continue; }
+        script = argv[i];
+    }
+
+    if (save) {
+        int status = lgrammar_write(stdout,
+            Number, Symbol, Sexpression, Qexpression, Expression, Lispy);
+        mpc_cleanup(6, Number, Symbol, Sexpression, Qexpression, Expression, Lispy);
+        return status;
+    }
+
+    mpca_lang_load((const char*)lispy_grammar_saved, sizeof(lispy_grammar_saved),
+        MPCA_LANG_DEFAULT, lispy_grammar,
+        Number, Symbol, Sexpression, Qexpression, Expression, Lispy);
+
+    tag_number = mpc_tag_id("number");
+    tag_symbol = mpc_tag_id("symbol");
+    tag_sexpr  = mpc_tag_id("sexpr");
+    tag_qexpr  = mpc_tag_id("qexpr");
+
+    lbuiltins_init();
+
+    if (script) {
+        int status = lbatch_run(script, Lispy);
+        if (stats) { lpool_print_stats(stderr); }
+        mpc_cleanup(6, Number, Symbol, Sexpression, Qexpression, Expression, Lispy);
+        return status;
+    }
 
     /* do parsing here */
     puts("Lispy version 0.0.0.0.5");
     puts("Press  Ctrl+c to Exit\n");
 
+    /* Trees read by mpc are thrown away a form at a time */
+    mpc_ast_arena_t* trees = mpc_ast_arena_new();
+    mpc_context_t* reader = mpc_context_new("<stdin>");
+    lreader lines = { 0 };
+
     while (1) {
 
         char* input = readline("lispy> ");
-        
-        mpc_result_t r;
-        if (mpc_parse("<stdin>", input, Lispy, &r)) {
-            lval* x = lval_eval(lval_read(r.output));
+        if (!input) { break; }
+
+        larena_begin();
+
+        /* Lines are read until every open paren is closed */
+        lreader_begin(&lines);
+        int state = lreader_feed(&lines, input);
+        while (state == LREAD_MORE) {
+            free(input);
+            input = readline(".....> ");
+            if (!input) { break; }
+            state = lreader_feed(&lines, input);
+        }
+
+        /* Read directly, mpc only sees forms the direct reader rejects */
+        lval* x = lreader_end(&lines);
+        if (!x) {
+            mpc_result_t r;
+            if (mpc_parse_context_arena(reader, lines.buf, Lispy, &r, trees)) {
+                x = lval_read(r.output);
+                mpc_ast_arena_clear(trees);
+            } else {
+                /*otherwise print error */
+                mpc_err_print(r.error);
+                mpc_err_delete(r.error);
+            }
+        }
+
+        if (x) {
+            x = lval_eval(x);
             lval_println(x);
+            lwriter_flush(&lout);
             lval_del(x);
-            mpc_ast_delete(r.output);
-        } else {
-            /*otherwise print error */
-            mpc_err_print(r.error);
-            mpc_err_delete(r.error);
         }
+        larena_end();
 
+        /* A form left open at the end of input has been reported */
+        if (!input) { break; }
         free(input);
     }
 
+    free(lines.open);
+    free(lines.close);
+    free(lines.buf);
+    mpc_context_delete(reader);
+    mpc_ast_arena_delete(trees);
+
+    if (stats) { lpool_print_stats(stderr); }
+
     mpc_cleanup(6, Number, Symbol, Sexpression, Qexpression, Expression, Lispy);
 
 
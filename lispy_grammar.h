@@ -0,0 +1,227 @@
+/* Written by lispy -g from the grammar in lispy.c, do not edit */
+
+static const unsigned char lispy_grammar_saved[] = {
+    0x6d, 0x70, 0x63, 0x01, 0xa1, 0xe3, 0xb6, 0xf7, 0x0c, 0x06, 0x18, 0x02,
+    0x20, 0x01, 0x07, 0x10, 0x21, 0x05, 0x72, 0x65, 0x67, 0x65, 0x78, 0x0f,
+    0x1f, 0x18, 0x02, 0x16, 0x02, 0x1a, 0x03, 0x03, 0x00, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x00, 0x00, 0x01, 0x03, 0x00, 0x02, 0x03, 0x00, 0x00, 0x03, 0x00, 0x00,
+    0x18, 0x02, 0x1c, 0x01, 0x13, 0x00, 0x04, 0x05, 0x03, 0x27, 0x2d, 0x27,
+    0x09, 0x2d, 0x15, 0x00, 0x1c, 0x00, 0x05, 0x13, 0x6f, 0x6e, 0x65, 0x20,
+    0x6f, 0x66, 0x20, 0x27, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37,
+    0x38, 0x39, 0x27, 0x0a, 0x0a, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36,
+    0x37, 0x38, 0x39, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70,
+    0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65,
+    0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f,
+    0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06,
+    0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x1b, 0x00, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x09, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x07, 0x05, 0x0b, 0x06, 0x0b, 0x08, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0a, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x04, 0x0b, 0x0b, 0x01, 0x0b, 0x03, 0x0b, 0x00, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x02, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x17, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x06, 0x73, 0x74,
+    0x72, 0x69, 0x6e, 0x67, 0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02, 0x05, 0x06,
+    0x22, 0x6c, 0x69, 0x73, 0x74, 0x22, 0x0e, 0x04, 0x6c, 0x69, 0x73, 0x74,
+    0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14, 0x00,
+    0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61,
+    0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27,
+    0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c, 0x0a,
+    0x0d, 0x09, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x06, 0x73,
+    0x74, 0x72, 0x69, 0x6e, 0x67, 0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02, 0x05,
+    0x06, 0x22, 0x68, 0x65, 0x61, 0x64, 0x22, 0x0e, 0x04, 0x68, 0x65, 0x61,
+    0x64, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63,
+    0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14,
+    0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70,
+    0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20,
+    0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c,
+    0x0a, 0x0d, 0x09, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x06,
+    0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02,
+    0x05, 0x06, 0x22, 0x74, 0x61, 0x69, 0x6c, 0x22, 0x0e, 0x04, 0x74, 0x61,
+    0x69, 0x6c, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61,
+    0x63, 0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73,
+    0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73,
+    0x70, 0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66,
+    0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20,
+    0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21,
+    0x06, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x0f, 0x1f, 0x18, 0x02, 0x16,
+    0x02, 0x05, 0x06, 0x22, 0x6a, 0x6f, 0x69, 0x6e, 0x22, 0x0e, 0x04, 0x6a,
+    0x6f, 0x69, 0x6e, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70,
+    0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65,
+    0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f,
+    0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06,
+    0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07, 0x10,
+    0x21, 0x06, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x0f, 0x1f, 0x18, 0x02,
+    0x16, 0x02, 0x05, 0x06, 0x22, 0x65, 0x76, 0x61, 0x6c, 0x22, 0x0e, 0x04,
+    0x65, 0x76, 0x61, 0x6c, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73,
+    0x70, 0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63,
+    0x65, 0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74,
+    0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20,
+    0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a,
+    0x06, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07,
+    0x10, 0x21, 0x04, 0x63, 0x68, 0x61, 0x72, 0x0f, 0x1f, 0x18, 0x02, 0x16,
+    0x02, 0x05, 0x03, 0x27, 0x2b, 0x27, 0x09, 0x2b, 0x05, 0x0a, 0x77, 0x68,
+    0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06,
+    0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a,
+    0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f,
+    0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d,
+    0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18,
+    0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x04, 0x63, 0x68, 0x61, 0x72, 0x0f,
+    0x1f, 0x18, 0x02, 0x16, 0x02, 0x05, 0x03, 0x27, 0x2d, 0x27, 0x09, 0x2d,
+    0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14, 0x00,
+    0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61,
+    0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27,
+    0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c, 0x0a,
+    0x0d, 0x09, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x04, 0x63,
+    0x68, 0x61, 0x72, 0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02, 0x05, 0x03, 0x27,
+    0x2a, 0x27, 0x09, 0x2a, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73,
+    0x70, 0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63,
+    0x65, 0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74,
+    0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20,
+    0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a,
+    0x06, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07,
+    0x10, 0x21, 0x04, 0x63, 0x68, 0x61, 0x72, 0x0f, 0x1f, 0x18, 0x02, 0x16,
+    0x02, 0x05, 0x03, 0x27, 0x2f, 0x27, 0x09, 0x2f, 0x05, 0x0a, 0x77, 0x68,
+    0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06,
+    0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a,
+    0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f,
+    0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d,
+    0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18,
+    0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x04, 0x63, 0x68, 0x61, 0x72, 0x0f,
+    0x1f, 0x18, 0x02, 0x16, 0x02, 0x05, 0x03, 0x27, 0x25, 0x27, 0x09, 0x25,
+    0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14, 0x00,
+    0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61,
+    0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27,
+    0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c, 0x0a,
+    0x0d, 0x09, 0x0b, 0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x04, 0x63,
+    0x68, 0x61, 0x72, 0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02, 0x05, 0x03, 0x27,
+    0x5e, 0x27, 0x09, 0x5e, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73,
+    0x70, 0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63,
+    0x65, 0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74,
+    0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20,
+    0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a,
+    0x06, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x18, 0x03, 0x1e, 0x23, 0x23,
+    0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x04, 0x63, 0x68, 0x61, 0x72,
+    0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02, 0x05, 0x03, 0x27, 0x28, 0x27, 0x09,
+    0x28, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63,
+    0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14,
+    0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70,
+    0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20,
+    0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c,
+    0x0a, 0x0d, 0x09, 0x0b, 0x14, 0x00, 0x1e, 0x00, 0x18, 0x02, 0x20, 0x01,
+    0x07, 0x0f, 0x25, 0x10, 0x22, 0x04, 0x65, 0x78, 0x70, 0x72, 0xff, 0x04,
+    0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x04, 0x63, 0x68, 0x61, 0x72,
+    0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02, 0x05, 0x03, 0x27, 0x29, 0x27, 0x09,
+    0x29, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63,
+    0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14,
+    0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70,
+    0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20,
+    0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c,
+    0x0a, 0x0d, 0x09, 0x0b, 0x18, 0x03, 0x1e, 0x23, 0x23, 0x18, 0x02, 0x20,
+    0x01, 0x07, 0x10, 0x21, 0x04, 0x63, 0x68, 0x61, 0x72, 0x0f, 0x1f, 0x18,
+    0x02, 0x16, 0x02, 0x05, 0x03, 0x27, 0x7b, 0x27, 0x09, 0x7b, 0x05, 0x0a,
+    0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x05,
+    0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14, 0x00, 0x1c, 0x00,
+    0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c,
+    0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c, 0x0a, 0x0d, 0x09,
+    0x0b, 0x14, 0x00, 0x1e, 0x00, 0x18, 0x02, 0x20, 0x01, 0x07, 0x0f, 0x25,
+    0x10, 0x22, 0x04, 0x65, 0x78, 0x70, 0x72, 0xff, 0x04, 0x18, 0x02, 0x20,
+    0x01, 0x07, 0x10, 0x21, 0x04, 0x63, 0x68, 0x61, 0x72, 0x0f, 0x1f, 0x18,
+    0x02, 0x16, 0x02, 0x05, 0x03, 0x27, 0x7d, 0x27, 0x09, 0x7d, 0x05, 0x0a,
+    0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0f, 0x05,
+    0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65, 0x73, 0x14, 0x00, 0x1c, 0x00,
+    0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x20, 0x0c,
+    0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06, 0x20, 0x0c, 0x0a, 0x0d, 0x09,
+    0x0b, 0x1b, 0x01, 0x00, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x01, 0x04, 0x04, 0x02, 0x04, 0x01, 0x01, 0x04,
+    0x00, 0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x01, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x01, 0x04, 0x04, 0x01,
+    0x04, 0x01, 0x04, 0x01, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x01,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x03, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x17, 0x04, 0x18, 0x02, 0x20,
+    0x01, 0x07, 0x0f, 0x25, 0x10, 0x22, 0x06, 0x6e, 0x75, 0x6d, 0x62, 0x65,
+    0x72, 0xff, 0x00, 0x18, 0x02, 0x20, 0x01, 0x07, 0x0f, 0x25, 0x10, 0x22,
+    0x06, 0x73, 0x79, 0x6d, 0x62, 0x6f, 0x6c, 0xff, 0x01, 0x18, 0x02, 0x20,
+    0x01, 0x07, 0x0f, 0x25, 0x10, 0x22, 0x05, 0x73, 0x65, 0x78, 0x70, 0x72,
+    0xff, 0x02, 0x18, 0x02, 0x20, 0x01, 0x07, 0x0f, 0x25, 0x10, 0x22, 0x05,
+    0x71, 0x65, 0x78, 0x70, 0x72, 0xff, 0x03, 0x18, 0x03, 0x1e, 0x23, 0x23,
+    0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x05, 0x72, 0x65, 0x67, 0x65,
+    0x78, 0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02, 0x18, 0x02, 0x17, 0x01, 0x05,
+    0x0e, 0x73, 0x74, 0x61, 0x72, 0x74, 0x20, 0x6f, 0x66, 0x20, 0x69, 0x6e,
+    0x70, 0x75, 0x74, 0x05, 0x06, 0x61, 0x6e, 0x63, 0x68, 0x6f, 0x72, 0x06,
+    0x26, 0x03, 0x04, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70,
+    0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65,
+    0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f,
+    0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06,
+    0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x14, 0x00, 0x1e, 0x00, 0x18, 0x02,
+    0x20, 0x01, 0x07, 0x0f, 0x25, 0x10, 0x22, 0x04, 0x65, 0x78, 0x70, 0x72,
+    0xff, 0x04, 0x18, 0x02, 0x20, 0x01, 0x07, 0x10, 0x21, 0x05, 0x72, 0x65,
+    0x67, 0x65, 0x78, 0x0f, 0x1f, 0x18, 0x02, 0x16, 0x02, 0x18, 0x02, 0x17,
+    0x01, 0x05, 0x0c, 0x65, 0x6e, 0x64, 0x20, 0x6f, 0x66, 0x20, 0x69, 0x6e,
+    0x70, 0x75, 0x74, 0x05, 0x06, 0x61, 0x6e, 0x63, 0x68, 0x6f, 0x72, 0x06,
+    0x27, 0x03, 0x04, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65, 0x73, 0x70,
+    0x61, 0x63, 0x65, 0x0f, 0x05, 0x05, 0x06, 0x73, 0x70, 0x61, 0x63, 0x65,
+    0x73, 0x14, 0x00, 0x1c, 0x00, 0x05, 0x0a, 0x77, 0x68, 0x69, 0x74, 0x65,
+    0x73, 0x70, 0x61, 0x63, 0x65, 0x05, 0x0f, 0x6f, 0x6e, 0x65, 0x20, 0x6f,
+    0x66, 0x20, 0x27, 0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x27, 0x0a, 0x06,
+    0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b
+};